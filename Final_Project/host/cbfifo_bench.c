@@ -0,0 +1,142 @@
+/*****************************************************************************
+* Copyright (C) 2022 by Bhargav Dharmendra Chauhan
+*
+* Redistribution, modification or use of this software in source or binary
+* forms is permitted as long as the files maintain this copyright. Users are
+* permitted to modify this and use it to learn about the field of embedded
+* software. Bhargav Dharmendra Chauhan and the University of Colorado
+* are not liable for any misuse of this material.
+*
+*****************************************************************************/
+/*****************************************************************************
+*
+*    File name   : cbfifo_bench.c
+*    Description : measures the throughput of the uart circular buffer
+*                  against the previous byte by byte implementation
+*
+*    Author: Bhargav Dharmendra Chauhan
+*    Tools : gcc
+*    Date  : 10/19/2026
+*
+*    Build from the Final_Project folder:
+*      gcc -O2 -Isource -o cbfifo_bench host/cbfifo_bench.c source/cbfifo.c
+*
+*    Usage: cbfifo_bench [megabytes per chunk size]
+*
+*    The reference keeps the per byte loop and the modulo of the previous
+*    cbfifo, without the interrupt masking that has no host equivalent.
+*    A host divides in hardware, on the M0+ the modulo of a non constant
+*    is a library call, so the gap on target is larger than shown here.
+*
+*****************************************************************************/
+
+// including required libraries
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "cbfifo.h"
+
+#define DEFAULT_MEGABYTES 	(64)
+#define MEGABYTE 			(1000000LL)
+#define NS_PER_S 			(1000000000LL)
+#define BUFFER_SIZE 		(256)		// capacity of the uart fifos
+
+// previous implementation, byte by byte with a length counter
+typedef struct
+{
+	uint8_t buffer[BUFFER_SIZE];
+	unsigned int head;
+	unsigned int tail;
+	unsigned int length;
+} reference_fifo;
+
+// the capacity is read through a volatile like the old structure field,
+// so the compiler cannot turn the modulo into a mask
+static volatile unsigned int reference_size = BUFFER_SIZE;
+
+static size_t reference_enqueue(const void *buf, size_t nbyte, reference_fifo *fifo)
+{
+	const uint8_t *data = buf;
+	size_t written = 0;
+
+	while (written < nbyte && fifo->length != reference_size) {
+		fifo->buffer[fifo->head] = *data++;
+		fifo->head = (fifo->head + 1) % reference_size;
+		fifo->length++;
+		written++;
+	}
+	return written;
+}
+
+static size_t reference_dequeue(void *buf, size_t nbyte, reference_fifo *fifo)
+{
+	uint8_t *data = buf;
+	size_t read = 0;
+
+	while (read < nbyte && fifo->length != 0) {
+		*data++ = fifo->buffer[fifo->tail];
+		fifo->tail = (fifo->tail + 1) % reference_size;
+		fifo->length--;
+		read++;
+	}
+	return read;
+}
+
+static double now_s(void)
+{
+	struct timespec time;
+
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (double)(time.tv_sec * NS_PER_S + time.tv_nsec) / NS_PER_S;
+}
+
+int main(int argc, char **argv)
+{
+	static const size_t chunks[] = { 1, 16, 80, 200 };
+	long long total = (argc > 1 ? atoll(argv[1]) : DEFAULT_MEGABYTES) * MEGABYTE;
+	uint8_t in[BUFFER_SIZE], out[BUFFER_SIZE];
+	reference_fifo reference;
+	static uint8_t storage[BUFFER_SIZE];
+	cbfifo fifo;
+	unsigned checksum = 0;
+
+	for (int i = 0; i < BUFFER_SIZE; i++)
+		in[i] = (uint8_t)i;
+
+	printf("chunk   reference B/s      cbfifo B/s   speedup\n");
+	for (size_t c = 0; c < sizeof(chunks) / sizeof(chunks[0]); c++) {
+		size_t chunk = chunks[c];
+		long long moved;
+		double start, reference_s, cbfifo_s;
+
+		// start half way so the chunks keep crossing the end of the storage
+		memset(&reference, 0, sizeof(reference));
+		reference.head = reference.tail = BUFFER_SIZE / 2 + 1;
+		start = now_s();
+		for (moved = 0; moved < total; moved += chunk) {
+			reference_enqueue(in, chunk, &reference);
+			reference_dequeue(out, chunk, &reference);
+			checksum += out[chunk - 1];
+		}
+		reference_s = now_s() - start;
+
+		cbfifo_init(&fifo, storage, BUFFER_SIZE);
+		fifo.head = fifo.tail = BUFFER_SIZE / 2 + 1;
+		start = now_s();
+		for (moved = 0; moved < total; moved += chunk) {
+			cbfifo_enqueue(in, chunk, &fifo);
+			cbfifo_dequeue(out, chunk, &fifo);
+			checksum += out[chunk - 1];
+		}
+		cbfifo_s = now_s() - start;
+
+		printf("%5u %15.0f %15.0f %8.1fx\n", (unsigned)chunk, moved / reference_s,
+				moved / cbfifo_s, reference_s / cbfifo_s);
+	}
+
+	// keeps the copies from being optimized out
+	printf("checksum %u\n", checksum);
+	return 0;
+}
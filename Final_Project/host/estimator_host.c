@@ -0,0 +1,206 @@
+/*****************************************************************************
+* Copyright (C) 2022 by Bhargav Dharmendra Chauhan
+*
+* Redistribution, modification or use of this software in source or binary
+* forms is permitted as long as the files maintain this copyright. Users are
+* permitted to modify this and use it to learn about the field of embedded
+* software. Bhargav Dharmendra Chauhan and the University of Colorado
+* are not liable for any misuse of this material.
+*
+*****************************************************************************/
+/*****************************************************************************
+*
+*    File name   : estimator_host.c
+*    Description : compares the angle estimator with the raw roll angle on a
+*                  host, for the synthetic ramp or a recorded trace
+*
+*    Author: Bhargav Dharmendra Chauhan
+*    Tools : gcc
+*    Date  : 10/19/2026
+*
+*    Build from the Final_Project folder:
+*      gcc -O2 -Isource -Ihost -o estimator_host host/estimator_host.c
+*          host/sensor_host.c source/tilt.c source/fp_math.c
+*          source/angle_estimator.c source/trace.c -lm
+*
+*    Usage: estimator_host [target angle in degrees]
+*             noisy ramp from 0 to the target, then still
+*           estimator_host -r trace.bin
+*             trace recorded with TRACE_CAPTURE, text logged before the
+*             trace header is skipped. The trace must end still
+*
+*    Every sample is converted with compute_tilt() without the filters, as
+*    read_roll_angle() does, and fed to angle_estimator_update() with the
+*    settings of the pipeline. For both the raw and the estimated roll the
+*    report gives:
+*      settling time	from the first sample until the angle stays within
+*						PIPELINE_TARGET_TOLERANCE of the final angle
+*      steady RMS		error to the final angle over the last
+*						STEADY_SAMPLES samples
+*    The final angle is the ramp end, or for a trace the mean raw roll of
+*    the last STEADY_SAMPLES samples.
+*
+*    The exit status is 1 when the estimate does not settle or is not less
+*    noisy than the raw angle.
+*
+*****************************************************************************/
+
+// including required libraries
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sensor.h"
+#include "sensor_host.h"
+#include "angle_estimator.h"
+#include "fp_math.h"
+#include "pipeline.h"
+#include "tilt.h"
+#include "trace.h"
+
+#define DEFAULT_TARGET 		(30)		// degrees
+#define SYNTHETIC_SAMPLES 	(1000)		// 10 s
+#define RAMP_SAMPLES 		(100)		// 1 s of motion
+#define NOISE_COUNTS 		(64)		// same as the pipeline_host ramp
+#define PERIOD_US 			(10000)
+#define STEADY_SAMPLES 		(500)		// end of the run used for the RMS
+#define SETTLE_BAND 		(PIPELINE_TARGET_TOLERANCE)
+#define GROW_SAMPLES 		(4096)
+#define US_PER_MS 			(1000)
+#define MAGIC_BYTES 		(4)
+
+// one compared output
+typedef struct
+{
+	const char *name;
+	angle_t *angle;				// one angle per sample
+} series_t;
+
+static FILE *trace_file;
+
+// trace stream on a file
+static size_t file_read(uint8_t *data, size_t length)
+{
+	return fread(data, 1, length, trace_file);
+}
+
+// positions the file on the trace header, after any text logged before it
+static int find_header(void)
+{
+	uint32_t window = 0;
+	long offset = 0;
+	int byte;
+
+	while ((byte = fgetc(trace_file)) != EOF) {
+		window = (window >> 8) | ((uint32_t)byte << 24);
+		if (++offset >= MAGIC_BYTES && window == TRACE_MAGIC)
+			return fseek(trace_file, offset - MAGIC_BYTES, SEEK_SET) == 0;
+	}
+	return 0;
+}
+
+// first sample after which the angle stays within the band, count if never
+static uint32_t settle_index(const angle_t *angle, uint32_t count, angle_t final)
+{
+	uint32_t settled = count;
+
+	while (settled > 0 && abs(angle[settled - 1] - final) <= SETTLE_BAND)
+		settled--;
+	return settled;
+}
+
+// error to the final angle over the steady part, cdeg
+static double steady_rms(const angle_t *angle, uint32_t count, uint32_t steady,
+		angle_t final)
+{
+	double sum = 0;
+
+	for (uint32_t i = count - steady; i < count; i++)
+		sum += (double)(angle[i] - final) * (angle[i] - final);
+	return sqrt(sum / steady);
+}
+
+int main(int argc, char *argv[])
+{
+	int replay = argc > 2 && strcmp(argv[1], "-r") == 0;
+	angle_t final = (!replay && argc > 1 ? atoi(argv[1]) : DEFAULT_TARGET) * CDEG_PER_DEGREE;
+	sensor_host_trajectory_t trajectory = { 0, final, RAMP_SAMPLES, NOISE_COUNTS, PERIOD_US };
+	const sensor_driver_t *sensor = &host_sensor;
+	uint32_t period_us = PERIOD_US;
+	uint32_t samples = SYNTHETIC_SAMPLES, count = 0, capacity = 0, steady, settled[2];
+	angle_estimator_t estimator;
+	series_t series[2] = { { "raw roll", NULL }, { "estimator", NULL } };
+	uint64_t *timestamp = NULL, previous = 0;
+	int16_t xyz[AXIS_COUNT];
+	tilt_t tilt;
+	double rms[2];
+	double mean = 0;
+
+	sensor_host_set_trajectory(&trajectory);
+	sensor->init();
+
+	if (replay) {
+		trace_file = fopen(argv[2], "rb");
+		if (!trace_file || !find_header() || !(period_us = trace_replay_start(file_read, NULL, NULL))) {
+			printf("no trace in %s\n", argv[2]);
+			return 1;
+		}
+		sensor = &trace_sensor;
+		samples = UINT32_MAX;
+	}
+	angle_estimator_init(&estimator, PIPELINE_PROCESS_NOISE, PIPELINE_MEASUREMENT_NOISE,
+			period_us);
+
+	// the whole run is kept, the final angle of a trace is only known at its end
+	while (count < samples && sensor->read_burst(xyz) == I2C_OK) {
+		if (count == capacity) {
+			capacity += GROW_SAMPLES;
+			timestamp = realloc(timestamp, capacity * sizeof(*timestamp));
+			for (int s = 0; s < 2; s++)
+				series[s].angle = realloc(series[s].angle, capacity * sizeof(angle_t));
+			if (!timestamp || !series[0].angle || !series[1].angle)
+				return 1;
+		}
+		timestamp[count] = sensor->get_timestamp_us();
+		if (count == 0)
+			previous = timestamp[count] - period_us;
+
+		compute_tilt(xyz, &tilt);
+		series[0].angle[count] = tilt.roll;
+		series[1].angle[count] = angle_estimator_update(&estimator, tilt.roll,
+				(uint32_t)(timestamp[count] - previous));
+		previous = timestamp[count];
+		count++;
+	}
+	if (count < 2) {
+		printf("not enough samples\n");
+		return 1;
+	}
+	steady = (count < 2 * STEADY_SAMPLES) ? count / 2 : STEADY_SAMPLES;
+
+	if (replay) {
+		for (uint32_t i = count - steady; i < count; i++)
+			mean += series[0].angle[i];
+		final = (angle_t)lround(mean / steady);
+	}
+
+	printf("driver %s, %u samples every %u us, final angle " ANGLE_FMT
+			" degree, band +/-" ANGLE_FMT "\n", sensor->name, (unsigned)count,
+			(unsigned)period_us, ANGLE_ARGS(final), ANGLE_ARGS(SETTLE_BAND));
+	if (!replay)
+		printf("ramp ends at %u ms\n", (unsigned)(RAMP_SAMPLES * period_us / US_PER_MS));
+
+	for (int s = 0; s < 2; s++) {
+		settled[s] = settle_index(series[s].angle, count, final);
+		rms[s] = steady_rms(series[s].angle, count, steady, final);
+		if (settled[s] < count)
+			printf("%-10s settles at %6u ms, steady RMS %6.1f cdeg\n", series[s].name,
+					(unsigned)((timestamp[settled[s]] - timestamp[0]) / US_PER_MS), rms[s]);
+		else
+			printf("%-10s never settles,     steady RMS %6.1f cdeg\n", series[s].name,
+					rms[s]);
+	}
+
+	return (settled[1] == count || rms[1] >= rms[0]) ? 1 : 0;
+}
@@ -0,0 +1,168 @@
+/*****************************************************************************
+* Copyright (C) 2022 by Bhargav Dharmendra Chauhan
+*
+* Redistribution, modification or use of this software in source or binary
+* forms is permitted as long as the files maintain this copyright. Users are
+* permitted to modify this and use it to learn about the field of embedded
+* software. Bhargav Dharmendra Chauhan and the University of Colorado
+* are not liable for any misuse of this material.
+*
+*****************************************************************************/
+/*****************************************************************************
+*
+*    File name   : pipeline_host.c
+*    Description : runs the per sample pipeline of the firmware (pipeline.c)
+*                  on a host, using the host sensor driver
+*
+*    Author: Bhargav Dharmendra Chauhan
+*    Tools : gcc
+*    Date  : 10/19/2026
+*
+*    Build from the Final_Project folder:
+*      gcc -O2 -Isource -Ihost -o pipeline_host host/pipeline_host.c
+*          host/sensor_host.c source/pipeline.c source/acquisition.c
+*          source/tilt.c source/fp_math.c source/accel_filter.c
+*          source/angle_estimator.c source/trace.c -lm
+*
+*    Usage: pipeline_host [samples] [target angle in degrees]
+*             runs the synthetic ramp through the chain
+*           pipeline_host -r trace.bin [target angle in degrees]
+*             replays a trace recorded with TRACE_CAPTURE at maximum speed,
+*             text logged before the trace header is skipped
+*           pipeline_host -c trace.bin [samples] [target angle in degrees]
+*             also writes the synthetic samples as a trace
+*
+*    The exit status is 1 when the final angle is off the target by more
+*    than the tolerance or the target was never reported as reached.
+*
+*    The acquisition changes the sampling period as on the target: the
+*    synthetic driver takes the new period, a trace keeps the recorded one.
+*
+*****************************************************************************/
+
+// including required libraries
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "sensor.h"
+#include "sensor_host.h"
+#include "fp_math.h"
+#include "pipeline.h"
+#include "tilt.h"
+#include "trace.h"
+
+#define DEFAULT_SAMPLES 	(10000000)
+#define DEFAULT_TARGET 		(30)		// degrees
+#define RAMP_SAMPLES 		(1000)
+#define NOISE_COUNTS 		(64)
+#define PERIOD_US 			(10000)
+#define NS_PER_S 			(1000000000LL)
+#define MAGIC_BYTES 		(4)
+
+// driver of the pipeline, configured by the acquisition like on the target
+const sensor_driver_t *sensor = &host_sensor;
+
+static FILE *trace_file;
+
+// trace stream on a file
+static size_t file_read(uint8_t *data, size_t length)
+{
+	return fread(data, 1, length, trace_file);
+}
+
+static size_t file_write(const uint8_t *data, size_t length)
+{
+	return fwrite(data, 1, length, trace_file);
+}
+
+// positions the file on the trace header, after any text logged before it
+static int find_header(void)
+{
+	uint32_t window = 0;
+	long offset = 0;
+	int byte;
+
+	while ((byte = fgetc(trace_file)) != EOF) {
+		window = (window >> 8) | ((uint32_t)byte << 24);
+		if (++offset >= MAGIC_BYTES && window == TRACE_MAGIC)
+			return fseek(trace_file, offset - MAGIC_BYTES, SEEK_SET) == 0;
+	}
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	int replay = argc > 2 && strcmp(argv[1], "-r") == 0;
+	int capture = argc > 2 && strcmp(argv[1], "-c") == 0;
+	int arg = (replay || capture) ? 3 : 1;
+	uint32_t samples = (!replay && argc > arg) ? strtoul(argv[arg++], NULL, 0) : DEFAULT_SAMPLES;
+	angle_t target = ((argc > arg) ? atoi(argv[arg]) : DEFAULT_TARGET) * CDEG_PER_DEGREE;
+	sensor_host_trajectory_t trajectory = { 0, target, RAMP_SAMPLES, NOISE_COUNTS, PERIOD_US };
+	pipeline_t pipeline;
+	measurement_t measurement;
+	int64_t first_reached = -1, reached = 0;
+	struct timespec start, end;
+	double seconds;
+
+	sensor_host_set_trajectory(&trajectory);
+	sensor->init();
+
+	if (capture) {
+		trace_file = fopen(argv[2], "wb");
+		if (!trace_file || trace_capture(sensor, PERIOD_US, samples, file_write) != I2C_OK)
+			return 1;
+		fclose(trace_file);
+		printf("%u samples written to %s\n", (unsigned)samples, argv[2]);
+		sensor_host_set_trajectory(&trajectory);
+	}
+
+	// all records of the trace, at maximum speed
+	if (replay) {
+		trace_file = fopen(argv[2], "rb");
+		if (!trace_file || !find_header() || !trace_replay_start(file_read, NULL, NULL)) {
+			printf("no trace in %s\n", argv[2]);
+			return 1;
+		}
+		sensor = &trace_sensor;
+		samples = UINT32_MAX;
+	}
+
+	// same calls as tilt_measurement(), the reference is the level position
+	pipeline_init(&pipeline);
+	pipeline_start(&pipeline, 0, target);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (uint32_t i = 0; i < samples; i++) {
+		if (sensor->read_burst(measurement.sample.raw) != I2C_OK) {
+			if (!replay || !trace_replay_done() || i == 0)
+				return 1;
+			samples = i;
+			break;
+		}
+		measurement.sample.timestamp_us = sensor->get_timestamp_us();
+		pipeline_step(&pipeline, &measurement);
+
+		if (measurement.on_target) {
+			reached++;
+			if (first_reached < 0)
+				first_reached = i;
+		}
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	seconds = (double)((end.tv_sec - start.tv_sec) * NS_PER_S + end.tv_nsec - start.tv_nsec)
+			/ NS_PER_S;
+
+	printf("driver %s, %u samples in %.3f s: %.0f samples/s\n", sensor->name,
+			(unsigned)samples, seconds, samples / seconds);
+	printf("target " ANGLE_FMT " degree, final angle " ANGLE_FMT
+			", first reached at sample %lld, reached in %lld samples\n",
+			ANGLE_ARGS(target), ANGLE_ARGS(measurement.roll), (long long)first_reached,
+			(long long)reached);
+	printf("%u sampling period changes, final period %u us\n",
+			(unsigned)pipeline.acquisition.switches,
+			(unsigned)acquisition_period_us(&pipeline.acquisition));
+
+	return (first_reached < 0 || !measurement.on_target) ? 1 : 0;
+}
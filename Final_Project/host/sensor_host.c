@@ -0,0 +1,100 @@
+/*****************************************************************************
+* Copyright (C) 2022 by Bhargav Dharmendra Chauhan
+*
+* Redistribution, modification or use of this software in source or binary
+* forms is permitted as long as the files maintain this copyright. Users are
+* permitted to modify this and use it to learn about the field of embedded
+* software. Bhargav Dharmendra Chauhan and the University of Colorado
+* are not liable for any misuse of this material.
+*
+*****************************************************************************/
+/*****************************************************************************
+*
+*    File name   : sensor_host.c
+*    Description : sensor driver for a host build, generates the samples
+*                  of a board rolling along a straight ramp with noise
+*
+*    Author: Bhargav Dharmendra Chauhan
+*    Tools : gcc
+*    Date  : 10/19/2026
+*
+*****************************************************************************/
+
+// including required libraries
+#include <stdint.h>
+#include <math.h>
+#include "sensor_host.h"
+
+#define PI 					(3.14159265358979323846)
+#define CDEG_TO_RADIAN 		(PI / 18000.0)
+#define DEFAULT_PERIOD_US 	(10000)
+
+static sensor_host_trajectory_t trajectory = { 0, 0, 0, 0, DEFAULT_PERIOD_US };
+static uint32_t sample_index = 0;
+static uint64_t timestamp_us = 0;	// sum of the periods, which change with configure
+static uint32_t seed = 1;
+
+// function definition in header file
+void sensor_host_set_trajectory(const sensor_host_trajectory_t *new_trajectory)
+{
+	trajectory = *new_trajectory;
+	sample_index = 0;
+	timestamp_us = 0;
+	seed = 1;
+}
+
+// peak to peak noise from the same generator as the target benchmarks
+static int16_t noise(void)
+{
+	if (trajectory.noise_counts == 0)
+		return 0;
+	seed = seed * 1664525U + 1013904223U;
+	return (int16_t)((seed >> 16) % trajectory.noise_counts) - trajectory.noise_counts / 2;
+}
+
+// sensor interface: nothing to prepare
+static i2c_status_t host_init(void)
+{
+	sample_index = 0;
+	timestamp_us = 0;
+	return I2C_OK;
+}
+
+// sensor interface: next sample of the ramp, gravity split between Y and Z
+static i2c_status_t host_read_burst(int16_t xyz[AXIS_COUNT])
+{
+	double roll = trajectory.end_roll;
+
+	if (sample_index < trajectory.ramp_samples)
+		roll = trajectory.start_roll + (double)(trajectory.end_roll - trajectory.start_roll)
+				* sample_index / trajectory.ramp_samples;
+	roll *= CDEG_TO_RADIAN;
+
+	xyz[AXIS_X] = noise();
+	xyz[AXIS_Y] = (int16_t)lround(COUNTS_PER_G * sin(roll)) + noise();
+	xyz[AXIS_Z] = (int16_t)lround(COUNTS_PER_G * cos(roll)) + noise();
+	sample_index++;
+	timestamp_us += trajectory.period_us;
+	return I2C_OK;
+}
+
+// sensor interface: only the sample period applies
+static i2c_status_t host_configure(const sensor_config_t *config)
+{
+	trajectory.period_us = config->period_us;
+	return I2C_OK;
+}
+
+// sensor interface: time of the last sample read
+static uint64_t host_timestamp_us(void)
+{
+	return timestamp_us;
+}
+
+const sensor_driver_t host_sensor = {
+	"host synthetic",
+	host_init,
+	host_read_burst,
+	host_configure,
+	host_timestamp_us,
+};
@@ -0,0 +1,54 @@
+/*****************************************************************************
+* Copyright (C) 2022 by Bhargav Dharmendra Chauhan
+*
+* Redistribution, modification or use of this software in source or binary
+* forms is permitted as long as the files maintain this copyright. Users are
+* permitted to modify this and use it to learn about the field of embedded
+* software. Bhargav Dharmendra Chauhan and the University of Colorado
+* are not liable for any misuse of this material.
+*
+*****************************************************************************/
+/*****************************************************************************
+*
+*    File name   : sensor_host.h
+*    Description : sensor driver for a host build, generates the samples
+*                  of a board rolling along a straight ramp with noise
+*
+*    Author: Bhargav Dharmendra Chauhan
+*    Tools : gcc
+*    Date  : 10/19/2026
+*
+*    This folder is not part of the MCUXpresso build, see pipeline_host.c
+*    for the host build command.
+*
+*****************************************************************************/
+
+#ifndef SENSOR_HOST_H_
+#define SENSOR_HOST_H_
+
+#include <stdint.h>
+#include "sensor.h"
+
+// motion generated by the host driver
+typedef struct
+{
+	angle_t start_roll;			// roll angle of the first sample
+	angle_t end_roll;			// roll angle at the end of the ramp
+	uint32_t ramp_samples;		// samples taken by the ramp, 0 for a step
+	uint16_t noise_counts;		// peak to peak noise added to every axis
+	uint32_t period_us;			// time between two samples
+} sensor_host_trajectory_t;
+
+// synthetic sample driver
+extern const sensor_driver_t host_sensor;
+
+/*****************************************************************************
+* Selects the generated motion and restarts it at the first sample
+*
+* Parameters:
+*   trajectory		motion to generate
+*
+*****************************************************************************/
+void sensor_host_set_trajectory(const sensor_host_trajectory_t *trajectory);
+
+#endif /* SENSOR_HOST_H_ */
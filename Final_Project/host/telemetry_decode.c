@@ -0,0 +1,157 @@
+/*****************************************************************************
+* Copyright (C) 2022 by Bhargav Dharmendra Chauhan
+*
+* Redistribution, modification or use of this software in source or binary
+* forms is permitted as long as the files maintain this copyright. Users are
+* permitted to modify this and use it to learn about the field of embedded
+* software. Bhargav Dharmendra Chauhan and the University of Colorado
+* are not liable for any misuse of this material.
+*
+*****************************************************************************/
+/*****************************************************************************
+*
+*    File name   : telemetry_decode.c
+*    Description : converts a telemetry stream captured from the uart to
+*                  CSV, and reports lost frames and throughput
+*
+*    Author: Bhargav Dharmendra Chauhan
+*    Tools : gcc
+*    Date  : 10/19/2026
+*
+*    Build from the Final_Project folder:
+*      gcc -O2 -Isource -o telemetry_decode host/telemetry_decode.c
+*          source/telemetry.c
+*
+*    Usage: telemetry_decode [capture.bin] > records.csv
+*             reads standard input without a file, the report goes to
+*             standard error
+*
+*    Text printed by the firmware between frames is skipped: when the
+*    bytes before a delimiter do not decode, the last frame sized part
+*    of them is tried on its own.
+*
+*****************************************************************************/
+
+// including required libraries
+#include <stdint.h>
+#include <stdio.h>
+#include "telemetry.h"
+
+#define ENCODED_BYTES 		(TELEMETRY_FRAME_BYTES - 1)		// without the delimiter
+#define PENDING_BYTES 		(4096)		// longest text kept before a frame
+#define US_PER_S 			(1000000.0)
+
+// decoding statistics
+typedef struct
+{
+	uint64_t frames;
+	uint64_t bad_frames;
+	uint64_t lost_frames;		// missing from the sequence, not counting bad_frames
+	uint32_t bad_in_gap;		// bad frames since the last decoded one
+	uint64_t skipped_bytes;
+	uint64_t bytes;
+	double first_us;
+	double last_us;
+} decode_stats_t;
+
+static void print_record(const telemetry_record_t *record, double timestamp_us)
+{
+	printf("%u,%.0f,%d,%d,%d,%d,%d,%u,%u\n", record->sequence, timestamp_us,
+			record->xyz[AXIS_X], record->xyz[AXIS_Y], record->xyz[AXIS_Z],
+			(int)record->roll, (int)record->pitch,
+			record->flags & TELEMETRY_ON_TARGET,
+			(record->flags & TELEMETRY_RANGE_MASK) >> TELEMETRY_RANGE_SHIFT);
+}
+
+// decodes the bytes before a delimiter, a frame possibly preceded by text,
+// returns 0 if no frame was found
+static int decode_chunk(const uint8_t *chunk, size_t length, decode_stats_t *stats)
+{
+	static telemetry_record_t previous;
+	telemetry_record_t record;
+	double timestamp_us;
+	uint16_t gap;
+
+	if (!telemetry_decode(chunk, length, &record)) {
+		if (length <= ENCODED_BYTES
+				|| !telemetry_decode(&chunk[length - ENCODED_BYTES], ENCODED_BYTES, &record))
+			return 0;
+		stats->skipped_bytes += length - ENCODED_BYTES;
+	}
+
+	// timestamps and sequence numbers extended over their wrap around
+	if (stats->frames == 0) {
+		timestamp_us = record.timestamp_us;
+		stats->first_us = timestamp_us;
+	} else {
+		timestamp_us = stats->last_us + (uint32_t)(record.timestamp_us - previous.timestamp_us);
+
+		// corrupted frames fill part of the gap, they are counted apart
+		gap = (uint16_t)(record.sequence - previous.sequence - 1);
+		if (gap > stats->bad_in_gap)
+			stats->lost_frames += gap - stats->bad_in_gap;
+	}
+	stats->bad_in_gap = 0;
+	stats->last_us = timestamp_us;
+	stats->frames++;
+	previous = record;
+
+	print_record(&record, timestamp_us);
+	return 1;
+}
+
+int main(int argc, char **argv)
+{
+	FILE *input = argc > 1 ? fopen(argv[1], "rb") : stdin;
+	static uint8_t pending[PENDING_BYTES];
+	size_t length = 0;
+	decode_stats_t stats = { 0 };
+	int synchronized = 0;
+	double seconds;
+	int byte;
+
+	if (!input) {
+		fprintf(stderr, "cannot open %s\n", argv[1]);
+		return 1;
+	}
+
+	printf("sequence,timestamp_us,x,y,z,roll_cdeg,pitch_cdeg,on_target,range\n");
+	while ((byte = fgetc(input)) != EOF) {
+		stats.bytes++;
+		if (byte != 0) {
+			// only the end of an overlong chunk can still be a frame
+			if (length == PENDING_BYTES) {
+				stats.skipped_bytes += PENDING_BYTES - ENCODED_BYTES;
+				for (size_t i = 0; i < ENCODED_BYTES; i++)
+					pending[i] = pending[PENDING_BYTES - ENCODED_BYTES + i];
+				length = ENCODED_BYTES;
+			}
+			pending[length++] = (uint8_t)byte;
+			continue;
+		}
+
+		// the stream may start in the middle of a frame, that is not a
+		// corrupted one
+		if (length != 0 && !decode_chunk(pending, length, &stats)) {
+			if (synchronized) {
+				stats.bad_frames++;
+				stats.bad_in_gap++;
+			}
+			else
+				stats.skipped_bytes += length;
+		}
+		synchronized = 1;
+		length = 0;
+	}
+	stats.skipped_bytes += length;
+
+	seconds = (stats.last_us - stats.first_us) / US_PER_S;
+	fprintf(stderr, "%llu frames, %llu lost, %llu corrupted, %llu bytes of text skipped\n",
+			(unsigned long long)stats.frames, (unsigned long long)stats.lost_frames,
+			(unsigned long long)stats.bad_frames, (unsigned long long)stats.skipped_bytes);
+	if (seconds > 0)
+		fprintf(stderr, "%.3f s of device time: %.1f frames/s, %.0f bytes/s, %.1f bytes"
+				" per frame\n", seconds, (stats.frames - 1) / seconds, stats.bytes / seconds,
+				(double)stats.bytes / stats.frames);
+	return 0;
+}
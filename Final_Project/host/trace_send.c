@@ -0,0 +1,191 @@
+/*****************************************************************************
+* Copyright (C) 2022 by Bhargav Dharmendra Chauhan
+*
+* Redistribution, modification or use of this software in source or binary
+* forms is permitted as long as the files maintain this copyright. Users are
+* permitted to modify this and use it to learn about the field of embedded
+* software. Bhargav Dharmendra Chauhan and the University of Colorado
+* are not liable for any misuse of this material.
+*
+*****************************************************************************/
+/*****************************************************************************
+*
+*    File name   : trace_send.c
+*    Description : serves a captured trace to a TRACE_REPLAY build over the
+*                  serial port, and works as its terminal meanwhile
+*
+*    Author: Bhargav Dharmendra Chauhan
+*    Tools : gcc
+*    Date  : 10/19/2026
+*
+*    Build from the Final_Project folder:
+*      gcc -O2 -Isource -o trace_send host/trace_send.c source/trace.c
+*
+*    Usage: trace_send /dev/ttyACM0 capture.bin
+*             start it before the target asks for the trace. Text from
+*             the target is printed, typed lines are sent to it with a
+*             carriage return (the target angle) until the replay starts.
+*
+*    The target pulls the trace one block at a time (see trace.h), so it
+*    is replayed at the recorded rate whatever the link does: nothing is
+*    sent that the target did not ask for. After the last record the
+*    requests are not answered, which the target takes as the end of the
+*    trace. Stop with Ctrl-C.
+*
+*****************************************************************************/
+
+// including required libraries
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/select.h>
+#include <termios.h>
+#include <unistd.h>
+#include "trace.h"
+
+#define MAGIC_BYTES 		(4)
+#define BLOCK_BYTES 		(TRACE_RECORD_BYTES + 1)	// largest block and its checksum
+#define INPUT_BYTES 		(256)
+#define CARRIAGE_RETURN 	(13)
+
+static uint8_t *trace;			// header then records
+static size_t trace_bytes;
+static long block = -1;			// last block sent
+
+// loads the capture and drops the text printed before the trace
+static int load_trace(const char *path)
+{
+	FILE *file = fopen(path, "rb");
+	uint8_t *data;
+	long size;
+	uint32_t window = 0;
+
+	if (!file || fseek(file, 0, SEEK_END) != 0 || (size = ftell(file)) <= 0) {
+		if (file)
+			fclose(file);
+		return 0;
+	}
+	rewind(file);
+	data = malloc(size);
+	if (!data || fread(data, 1, size, file) != (size_t)size) {
+		fclose(file);
+		return 0;
+	}
+	fclose(file);
+
+	for (long i = 0; i < size; i++) {
+		window = (window >> 8) | ((uint32_t)data[i] << 24);
+		if (i + 1 >= MAGIC_BYTES && window == TRACE_MAGIC) {
+			trace = &data[i + 1 - MAGIC_BYTES];
+			trace_bytes = size - (i + 1 - MAGIC_BYTES);
+			return trace_bytes >= TRACE_HEADER_BYTES;
+		}
+	}
+	return 0;
+}
+
+// opens the serial port raw at the uart rate
+static int open_port(const char *path)
+{
+	struct termios options;
+	int port = open(path, O_RDWR | O_NOCTTY);
+
+	if (port < 0 || tcgetattr(port, &options) != 0)
+		return -1;
+	cfmakeraw(&options);
+	cfsetispeed(&options, B38400);
+	cfsetospeed(&options, B38400);
+	options.c_cflag |= CLOCAL | CREAD;
+	options.c_cc[VMIN] = 1;
+	options.c_cc[VTIME] = 0;
+	if (tcsetattr(port, TCSANOW, &options) != 0)
+		return -1;
+	tcflush(port, TCIOFLUSH);
+	return port;
+}
+
+// answers a request, moving to the next block when its parity changed
+static void answer(int port, uint8_t request)
+{
+	uint8_t out[BLOCK_BYTES];
+	long wanted = (request == TRACE_REQUEST_ODD);
+	size_t offset, length;
+
+	if (block < 0 || ((block + 1) & 1) == wanted)
+		block++;
+
+	// block 0 is the header, block n is record n - 1
+	offset = block ? TRACE_HEADER_BYTES + (block - 1) * TRACE_RECORD_BYTES : 0;
+	length = block ? TRACE_RECORD_BYTES : TRACE_HEADER_BYTES;
+	if (offset + length > trace_bytes) {
+		block--;						// end of the trace, stay quiet
+		return;
+	}
+	memcpy(out, &trace[offset], length);
+	out[length] = trace_checksum(out, length);
+	if (write(port, out, length + 1) != (ssize_t)(length + 1))
+		perror("write");
+}
+
+int main(int argc, char *argv[])
+{
+	uint8_t input[INPUT_BYTES];
+	int port;
+	int typing = 1;				// forwards the keyboard until the replay starts
+	ssize_t count;
+	fd_set ready;
+
+	if (argc < 3) {
+		printf("usage: trace_send port capture.bin\n");
+		return 1;
+	}
+	if (!load_trace(argv[2])) {
+		printf("no trace in %s\n", argv[2]);
+		return 1;
+	}
+	if ((port = open_port(argv[1])) < 0) {
+		perror(argv[1]);
+		return 1;
+	}
+	fprintf(stderr, "%zu records, waiting for the target\n",
+			(trace_bytes - TRACE_HEADER_BYTES) / TRACE_RECORD_BYTES);
+
+	while (1) {
+		FD_ZERO(&ready);
+		FD_SET(port, &ready);
+		if (typing)
+			FD_SET(STDIN_FILENO, &ready);
+		if (select(port + 1, &ready, NULL, NULL, NULL) < 0)
+			break;
+
+		if (FD_ISSET(port, &ready)) {
+			if ((count = read(port, input, sizeof(input))) <= 0)
+				break;
+			for (ssize_t i = 0; i < count; i++) {
+				if (input[i] == TRACE_REQUEST_EVEN || input[i] == TRACE_REQUEST_ODD) {
+					// keys would be read as trace bytes from now on
+					typing = 0;
+					answer(port, input[i]);
+				} else {
+					putchar(input[i]);
+				}
+			}
+			fflush(stdout);
+		}
+
+		if (typing && FD_ISSET(STDIN_FILENO, &ready)) {
+			if ((count = read(STDIN_FILENO, input, sizeof(input))) <= 0) {
+				typing = 0;
+				continue;
+			}
+			for (ssize_t i = 0; i < count; i++)
+				if (input[i] == '\n')
+					input[i] = CARRIAGE_RETURN;
+			if (write(port, input, count) != count)
+				perror("write");
+		}
+	}
+	return 0;
+}
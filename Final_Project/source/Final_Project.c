@@ -37,6 +37,14 @@
 #include "uart.h"
 #include "led.h"
 #include "audio_out.h"
+#include "benchmark.h"
+#include "calibration.h"
+#include "timebase.h"
+#include "motion.h"
+#include "trace.h"
+#include "pipeline.h"
+#include "sample_bus.h"
+#include "telemetry.h"
 
 // macros definition
 #define NORMAL_DELAY_CONVERSION_VALUE (6000)
@@ -47,7 +55,25 @@
 #define TONE4 (1000)
 #define DELAY_100MS (100)
 #define DELAY_30MS (30)
-#define MAX_ANGLE_RANGE (180)
+#define MAX_ANGLE_RANGE (18000)		// centi-degrees
+#define MOTION_THRESHOLD_MG (126)	// movement that wakes the board
+#define MOTION_DEBOUNCE (4)			// samples above the threshold, 5 ms at MOTION_ODR
+#define MOTION_ODR (MMA_ODR_800HZ)	// sensor rate while asleep, sets the debounce time
+#define MOTION_IDLE_US (5000000)	// sleep after 5 s without movement
+#define PERCENT (100)
+#define SENSOR_ODR (MMA_ODR_800HZ)	// sensor output data rate
+#define SENSOR_MODS (MMA_MODS_NORMAL)	// oversampling, see benchmark_sensor_modes()
+#define SENSOR_LOW_NOISE (0)		// LNOISE, limits the range to +/-4g
+#define SENSOR_AUTO_RANGE (1)		// finest range that does not clip
+#define TRACE_PERIOD_US (10000)		// TRACE_CAPTURE sample period, the moving rate
+#define REPLAY_TIMEOUT_US (50000)	// TRACE_REPLAY wait for the sender, ~190 bytes at 38400
+#define REFERENCE_PERIOD_US (10000)	// sampling while waiting for the reference
+#define PRINT_PERIOD_US (100000)	// status line rate, independent of the sampling
+#define TELEMETRY_PERIOD_US (10000)	// frame rate, 2.3 kB/s of the 3.8 kB/s of the uart
+#define I2C_STATS_KEY ('i')			// prints the I2C_INSTRUMENTATION statistics
+#define UART_TX_DMA (1)				// uart output through DMA channel 1
+#define UART_RX_DMA (1)				// uart input through DMA channel 2
+#define LOOP_OUTPUT_POLICY (UART_TX_DROP_COUNTED)	// the sensor loop never waits for the uart
 
 
 /*****************************************************************************
@@ -69,43 +95,154 @@ void delay(int delay_time_ms) {
 	}
 }
 
+#ifdef TRACE_REPLAY
+// reads a block pulled from host/trace_send, short when the sender is quiet
+static size_t replay_read(uint8_t *data, size_t length) {
+	return uart_read_timeout(data, length, REPLAY_TIMEOUT_US);
+}
+#endif
+
+#ifndef TELEMETRY
 /*****************************************************************************
- * Function which performs entire project functionality in defined flow
+ * Bus subscriber printing the measurements, decimated to PRINT_PERIOD_US
  *
  *****************************************************************************/
-void tilt_measurement() {
+static void print_measurement(const measurement_t *measurement, void *context) {
+	static uint32_t dropped = 0;
+	uint32_t total = uart_tx_dropped();
 
-	// local variables
-	uint16_t dac_buffer[BUFFER_SIZE];
+	(void)context;
+
+	// output discarded by the policy since the last report, a report that
+	// is dropped itself shows in the next one
+	if (total != dropped) {
+		printf("%d bytes of output dropped\n\r", (int)(total - dropped));
+		dropped = total;
+	}
+	printf("[%d ms] Roll angle from reference is " ANGLE_FMT " degree, pitch "
+			ANGLE_FMT "\n\r", (int)(measurement->sample.timestamp_us / 1000),
+			ANGLE_ARGS(measurement->roll), ANGLE_ARGS(measurement->pitch));
+}
+#else
+/*****************************************************************************
+ * Bus subscriber sending the measurements as binary telemetry frames,
+ * decimated to TELEMETRY_PERIOD_US, a frame dropped by the output policy
+ * shows as a gap in the sequence
+ *
+ *****************************************************************************/
+static void send_telemetry(const measurement_t *measurement, void *context) {
+	static uint16_t sequence = 0;
+	telemetry_record_t record;
+	uint8_t frame[TELEMETRY_FRAME_BYTES];
+
+	(void)context;
+
+	record.sequence = sequence++;
+	record.timestamp_us = (uint32_t)measurement->sample.timestamp_us;
+	for (int axis = 0; axis < AXIS_COUNT; axis++)
+		record.xyz[axis] = measurement->sample.raw[axis];
+	record.roll = measurement->roll;
+	record.pitch = measurement->pitch;
+	record.flags = (measurement->on_target ? TELEMETRY_ON_TARGET : 0)
+			| (mma_get_range() << TELEMETRY_RANGE_SHIFT);
+
+	uart_write(frame, telemetry_encode(&record, frame));
+}
+#endif
+
+/*****************************************************************************
+ * Bus subscriber driving the LED and the buzzer from the target decision
+ *
+ *****************************************************************************/
+static void target_feedback(const measurement_t *measurement, void *context) {
+	static uint16_t dac_buffer[BUFFER_SIZE];
 	// frequency array: add new frequencies here
-	int frequency[] = { TONE1, TONE2, TONE3, TONE4 };
+	static const int frequency[] = { TONE1, TONE2, TONE3, TONE4 };
 	// computing the size of the above array
 	uint8_t number_of_frequencies = sizeof(frequency) / sizeof(frequency[0]);
-	uint32_t samples = 0, i = 0;
-	uint16_t target_angle = 0;
+	static uint32_t i = 0;
+	uint32_t samples;
+
+	(void)context;
+
+	// if target angle reached
+	if (measurement->on_target) {
+
+		// green light
+		control_RGB_led(0, 1, 0);
+
+		// play tone on buzzer
+		while (i < number_of_frequencies) {
+			// generate the samples of provided frequency and store into the buffer
+			samples = tone_to_samples(frequency[i], dac_buffer, BUFFER_SIZE);
+			// generate the dma buffer for DMA transfer
+			generate_dma_buffer(dac_buffer, samples);
+			// start the dma transfer
+			start_DMA0_transfer();
+
+			delay(DELAY_30MS);
+			// increment i or wrap around the loop
+			i++;
+
+		}
+
+	} else {
+		// stop the buzzer
+		TPM0->SC &= ~TPM_SC_CMOD_MASK;
+		// red light
+		control_RGB_led(1, 0, 0);
+	}
+}
+
+/*****************************************************************************
+ * Function which performs entire project functionality in defined flow
+ *
+ *****************************************************************************/
+void tilt_measurement() {
+
+	// local variables
+	angle_t target_angle = 0;
 	uint8_t angle_flag = 0;
-	int max_angle = 0;
-	int roll_angle;
+	angle_t max_angle = 0;
+	sample_t sample;
+	measurement_t *measurement;
+	uint64_t loop_start;
+	pipeline_t pipeline;
+	motion_stats_t motion_stats;
+	uint64_t slept_us;
+	int output_subscriber;
+	uint32_t output_period_us;
+	i2c_status_t status;
 
 
 	// print uart commands
 	printf("Set the reference angle:\n\r\t");
 	printf("By adjusting the axis and pressing tactile switch\n\n\r");
-	while (!reference_angle_flag)
-		;
-	printf("Reference angle is %d degree on roll_angle axis\n\r",
-			reference_angle);
+
+	// keep sampling, the switch takes the latest sample as the reference
+	pipeline_init(&pipeline);
+	while (!reference_angle_flag) {
+		loop_start = timebase_now_us();
+		if (read_sample(&sample) == I2C_OK) {
+			pipeline_filter(&pipeline, &sample);
+			publish_sample(&sample);
+		}
+		while (timebase_now_us() - loop_start < REFERENCE_PERIOD_US)
+			;
+	}
+	printf("Reference angle is " ANGLE_FMT " degree on roll_angle axis\n\r",
+			ANGLE_ARGS(reference_angle));
 	// reduce the range
 	max_angle = MAX_ANGLE_RANGE - reference_angle;
 
 	// take input angle until valid input
 	do {
 		printf("\n\r");
-		printf("Enter target angle using UART, Range: 0 to %d degree: ",
-				max_angle);
+		printf("Enter target angle using UART, Range: 0 to " ANGLE_FMT " degree: ",
+				ANGLE_ARGS(max_angle));
 
-		// store in variable
-		target_angle = get_deci_input();
+		// store in variable, input is in degrees with up to two decimals
+		target_angle = get_centi_input();
 
 		// compare the input angle with correct range
 		if (target_angle >= 0 && target_angle <= max_angle) {
@@ -118,45 +255,102 @@ void tilt_measurement() {
 	} while (angle_flag);
 
 	// print the target angle
-	printf("Target Angle selected: %d\n\r", target_angle);
+	printf("Target Angle selected: " ANGLE_FMT "\n\r", ANGLE_ARGS(target_angle));
+
+#ifdef TRACE_REPLAY
+	// the rest of the run uses the recorded samples pulled over the uart
+	// from host/trace_send, one record per request
+	printf("Replaying the trace from trace_send\n\r");
+	if (!trace_replay_start(replay_read, uart_write, timebase_now_us)) {
+		printf("Invalid trace header\n\r");
+		return;
+	}
+	sensor = &trace_sensor;
+#endif
 
-	// infinite loop to measure the angle continuously
-	while (1) {
+	// estimators and sampling rate, configures the sensor for the moving rate
+	pipeline_start(&pipeline, reference_angle, target_angle);
+
+	// every measurement feeds the feedback, the uart cannot keep up with a
+	// line per measurement at the fast rates
+	sample_bus_subscribe(target_feedback, NULL, 1);
+#ifdef TELEMETRY
+	// frames instead of the status lines, at most one per TELEMETRY_PERIOD_US
+	output_period_us = TELEMETRY_PERIOD_US;
+	output_subscriber = sample_bus_subscribe(send_telemetry, NULL,
+			output_period_us / acquisition_period_us(&pipeline.acquisition));
+#else
+	output_period_us = PRINT_PERIOD_US;
+	output_subscriber = sample_bus_subscribe(print_measurement, NULL,
+			output_period_us / acquisition_period_us(&pipeline.acquisition));
+#endif
 
-		// call roll measurement function
-		roll_angle = read_roll_angle();
+#ifdef I2C_INSTRUMENTATION
+	printf("Press '%c' for I2C statistics\n\r", I2C_STATS_KEY);
+#endif
 
-		printf("Roll angle from reference is %d degree\n\r",
-				roll_angle - reference_angle);
+	// output that does not fit is dropped from here on, the prompts above
+	// were waited for
+	uart_flush();
+	uart_tx_policy(LOOP_OUTPUT_POLICY);
 
-		// if target angle reached
-		if (target_angle == (roll_angle - reference_angle)) {
+	// infinite loop to measure the angle continuously
+	while (1) {
+		loop_start = timebase_now_us();
 
-			// green light
-			control_RGB_led(0, 1, 0);
+#ifdef I2C_INSTRUMENTATION
+		// the uart carries the trace during a replay
+		if (sensor != &trace_sensor && uart_try_getchar() == I2C_STATS_KEY)
+			i2c_stats_dump();
+#endif
 
-			// play tone on buzzer
-			while (i < number_of_frequencies) {
-				// generate the samples of provided frequency and store into the buffer
-				samples = tone_to_samples(frequency[i], dac_buffer, BUFFER_SIZE);
-				// generate the dma buffer for DMA transfer
-				generate_dma_buffer(dac_buffer, samples);
-				// start the dma transfer
-				start_DMA0_transfer();
+		// stop sampling while the fixture is not moving, a replayed trace
+		// does not move it
+		motion_poll();
+		if (sensor == &mma8451_sensor && motion_is_idle()) {
+			printf("No movement, sleeping\n\r");
+			slept_us = motion_sleep();
+			motion_get_stats(&motion_stats);
+			printf("Movement detected after %d ms, asleep %d%% of the time\n\r",
+					(int)(slept_us / 1000),
+					(int)(motion_stats.asleep_us * PERCENT / motion_stats.total_us));
+
+			// the estimators restart from the nominal period
+			pipeline_restart(&pipeline);
+		}
 
-				delay(DELAY_30MS);
-				// increment i or wrap around the loop
-				i++;
+		// call tilt measurement function, skip the sample on a bus error
+		measurement = sample_bus_claim();
+		status = read_sample(&measurement->sample);
+		if (status != I2C_OK && sensor == &trace_sensor && trace_replay_done()) {
+			uart_tx_policy(UART_TX_BLOCK);
+			printf("End of trace, %d bytes of output dropped, %d input overruns\n\r",
+					(int)uart_tx_dropped(), (int)uart_rx_overruns());
+			uart_flush();
+			return;
+		}
+		if (status != I2C_OK) {
+			printf("Sensor read failed (error %d), recoveries %d\n\r", status,
+					(int)i2c_error_counters.recoveries);
+			delay(DELAY_100MS);
+			continue;
+		}
+		// filters, angles, target decision and sampling rate, the output
+		// rate stays the same when the sampling rate changes
+		if (pipeline_step(&pipeline, measurement)) {
+			if (output_subscriber >= 0)
+				sample_bus_set_decimation(output_subscriber,
+						output_period_us / acquisition_period_us(&pipeline.acquisition));
+			printf("Sampling every %d us\n\r", (int)acquisition_period_us(&pipeline.acquisition));
+		}
 
-			}
+		// one measurement for all the consumers, the latest one for the switch
+		publish_sample(&measurement->sample);
+		sample_bus_publish();
 
-		} else {
-			// stop the buzzer
-			TPM0->SC &= ~TPM_SC_CMOD_MASK;
-			// red light
-			control_RGB_led(1, 0, 0);
-		}
-		delay(DELAY_100MS);
+		// next sample at the period of the acquisition level
+		while (timebase_now_us() - loop_start < acquisition_period_us(&pipeline.acquisition))
+			;
 
 	}
 
@@ -188,8 +382,8 @@ int main(void) {
 	init_DAC0();
 	init_TPM0();
 	init_DMA0();
+	timebase_init();
 	i2c_init();
-	i2c_test();
 
 	// checking if mma initialized properly
 	if (!init_mma()) {
@@ -198,6 +392,50 @@ int main(void) {
 			;
 	}
 	printf("Accelerometer Initialized\n\r");
+	printf("I2C SCL running at %d Hz\n\r", (int)mma_device.speed_hz);
+	i2c_test();
+
+	// calibrate once, later boots reuse the calibration stored in flash
+#ifdef FORCE_CALIBRATION
+	calibration_run();
+#else
+	if (calibration_load())
+		printf("Calibration loaded from flash\n\r");
+	else
+		calibration_run();
+#endif
+
+#ifdef RUN_BENCHMARKS
+	benchmark_filters();
+	benchmark_estimator();
+	benchmark_i2c_speeds();
+	benchmark_sensor_modes();
+	benchmark_uart_tx();
+#endif
+
+	// one interrupt per span of output and per burst of input instead of
+	// per character
+	uart_tx_dma(UART_TX_DMA);
+	uart_rx_dma(UART_RX_DMA);
+
+	// hardware oversampling mode, chosen against the software filters below
+	mma_mode_t sensor_mode = { SENSOR_ODR, SENSOR_MODS, SENSOR_LOW_NOISE };
+	if (mma_set_mode(&sensor_mode) != I2C_OK)
+		printf("Sensor mode NOT set\n\r");
+	mma_auto_range(SENSOR_AUTO_RANGE);
+
+	// sleep while still, wake on movement on any axis
+	motion_config_t motion_config = { MOTION_THRESHOLD_MG, MOTION_DEBOUNCE, MOTION_AXIS_ALL,
+			MOTION_IDLE_US, MOTION_ODR };
+	if (!motion_init(&motion_config))
+		printf("Motion wake up NOT enabled\n\r");
+
+#ifdef TRACE_CAPTURE
+	// stream raw samples until reset, for replay on target or on a host
+	printf("Trace capture, %d us period\n\r", TRACE_PERIOD_US);
+	i2c_status_t capture_status = trace_capture(sensor, TRACE_PERIOD_US, 0, uart_write);
+	printf("\n\rTrace capture stopped (error %d)\n\r", capture_status);
+#endif
 
 	// measure the tilt
 	tilt_measurement();
@@ -0,0 +1,186 @@
+/*****************************************************************************
+* Copyright (C) 2022 by Bhargav Dharmendra Chauhan
+*
+* Redistribution, modification or use of this software in source or binary
+* forms is permitted as long as the files maintain this copyright. Users are
+* permitted to modify this and use it to learn about the field of embedded
+* software. Bhargav Dharmendra Chauhan and the University of Colorado
+* are not liable for any misuse of this material.
+*
+*****************************************************************************/
+/*****************************************************************************
+*
+*    File name   : accel_filter.c
+*    Description : fixed-point filter stages applied to accelerometer samples
+*                  between acquisition and angle computation
+*
+*    Author: Bhargav Dharmendra Chauhan
+*    Tools : MCUXpresso
+*    Date  : 10/19/2026
+*
+*****************************************************************************/
+
+// including required libraries
+#include <stdint.h>
+#include "accel_filter.h"
+
+#define IIR_FRACTION_BITS 	(8)		// IIR output is kept in Q8
+#define IIR_ROUNDING 		(1 << (IIR_FRACTION_BITS - 1))
+#define MEDIAN3_TAPS 		(3)
+#define MEDIAN5_TAPS 		(5)
+
+// moving average with a running sum, window is a power of two so no division
+static int16_t moving_average(filter_stage_t *stage, int16_t sample)
+{
+	uint8_t window = 1 << stage->param;
+
+	// fill the whole window with the first sample
+	if (!stage->primed) {
+		for (int i = 0; i < window; i++)
+			stage->history[i] = sample;
+		stage->state = (int32_t)sample << stage->param;
+		stage->index = 0;
+		stage->primed = 1;
+	}
+
+	// replace the oldest sample in the running sum
+	stage->state += sample - stage->history[stage->index];
+	stage->history[stage->index] = sample;
+	stage->index = (stage->index + 1) & (window - 1);
+
+	return (int16_t)(stage->state >> stage->param);
+}
+
+// single pole low pass, y += (x - y) / 2^k with the output held in Q8
+static int16_t iir(filter_stage_t *stage, int16_t sample)
+{
+	int32_t input = (int32_t)sample << IIR_FRACTION_BITS;
+
+	// start from the first sample instead of ramping up from zero
+	if (!stage->primed) {
+		stage->state = input;
+		stage->primed = 1;
+	}
+
+	stage->state += (input - stage->state) >> stage->param;
+
+	return (int16_t)((stage->state + IIR_ROUNDING) >> IIR_FRACTION_BITS);
+}
+
+// median of three values using comparisons only
+static int16_t median3(int16_t a, int16_t b, int16_t c)
+{
+	if (a > b) {
+		int16_t temp = a;
+		a = b;
+		b = temp;
+	}
+	// a <= b here
+	if (c <= a)
+		return a;
+	if (c >= b)
+		return b;
+	return c;
+}
+
+// 3 or 5 tap median over the most recent samples
+static int16_t median(filter_stage_t *stage, int16_t sample)
+{
+	int16_t sorted[MEDIAN5_TAPS];
+	int i, j;
+
+	// fill the window with the first sample
+	if (!stage->primed) {
+		for (i = 0; i < stage->param; i++)
+			stage->history[i] = sample;
+		stage->index = 0;
+		stage->primed = 1;
+	}
+
+	// store the new sample over the oldest one
+	stage->history[stage->index] = sample;
+	stage->index++;
+	if (stage->index >= stage->param)
+		stage->index = 0;
+
+	if (stage->param == MEDIAN3_TAPS)
+		return median3(stage->history[0], stage->history[1], stage->history[2]);
+
+	// insertion sort of the five taps, the middle element is the median
+	for (i = 0; i < MEDIAN5_TAPS; i++) {
+		int16_t value = stage->history[i];
+		for (j = i; j > 0 && sorted[j - 1] > value; j--)
+			sorted[j] = sorted[j - 1];
+		sorted[j] = value;
+	}
+	return sorted[MEDIAN5_TAPS / 2];
+}
+
+// function definition in header file
+void filter_chain_init(filter_chain_t *chain)
+{
+	chain->num_stages = 0;
+}
+
+// function definition in header file
+int filter_chain_add(filter_chain_t *chain, filter_type_t type, uint8_t param)
+{
+	filter_stage_t *stage;
+
+	// chain is full
+	if (chain->num_stages >= FILTER_MAX_STAGES)
+		return 0;
+
+	// check the parameter of the requested stage
+	switch (type) {
+	case FILTER_MOVING_AVERAGE:
+		if (param > FILTER_MA_MAX_SHIFT)
+			return 0;
+		break;
+	case FILTER_IIR:
+		if (param == 0 || param > FILTER_IIR_MAX_SHIFT)
+			return 0;
+		break;
+	case FILTER_MEDIAN:
+		if (param != MEDIAN3_TAPS && param != MEDIAN5_TAPS)
+			return 0;
+		break;
+	default:
+		return 0;
+	}
+
+	stage = &chain->stage[chain->num_stages];
+	stage->type = type;
+	stage->param = param;
+	stage->primed = 0;
+	chain->num_stages++;
+	return 1;
+}
+
+// function definition in header file
+void filter_chain_reset(filter_chain_t *chain)
+{
+	for (int i = 0; i < chain->num_stages; i++)
+		chain->stage[i].primed = 0;
+}
+
+// function definition in header file
+int16_t filter_chain_apply(filter_chain_t *chain, int16_t sample)
+{
+	for (int i = 0; i < chain->num_stages; i++) {
+		filter_stage_t *stage = &chain->stage[i];
+
+		switch (stage->type) {
+		case FILTER_MOVING_AVERAGE:
+			sample = moving_average(stage, sample);
+			break;
+		case FILTER_IIR:
+			sample = iir(stage, sample);
+			break;
+		case FILTER_MEDIAN:
+			sample = median(stage, sample);
+			break;
+		}
+	}
+	return sample;
+}
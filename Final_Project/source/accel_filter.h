@@ -0,0 +1,105 @@
+/*****************************************************************************
+* Copyright (C) 2022 by Bhargav Dharmendra Chauhan
+*
+* Redistribution, modification or use of this software in source or binary
+* forms is permitted as long as the files maintain this copyright. Users are
+* permitted to modify this and use it to learn about the field of embedded
+* software. Bhargav Dharmendra Chauhan and the University of Colorado
+* are not liable for any misuse of this material.
+*
+*****************************************************************************/
+/*****************************************************************************
+*
+*    File name   : accel_filter.h
+*    Description : fixed-point filter stages applied to accelerometer samples
+*                  between acquisition and angle computation
+*
+*    Author: Bhargav Dharmendra Chauhan
+*    Tools : MCUXpresso
+*    Date  : 10/19/2026
+*
+*****************************************************************************/
+
+#ifndef ACCEL_FILTER_H_
+#define ACCEL_FILTER_H_
+
+#include <stdint.h>
+
+// limits of the filter configuration
+#define FILTER_MAX_STAGES 		(4)		// stages per axis chain
+#define FILTER_MA_MAX_SHIFT 	(4)		// moving average of up to 16 samples
+#define FILTER_IIR_MAX_SHIFT 	(8)		// smallest IIR coefficient is 1/256
+#define FILTER_HISTORY_SIZE 	(1 << FILTER_MA_MAX_SHIFT)
+
+// supported filter stages
+typedef enum
+{
+	FILTER_MOVING_AVERAGE,		// param: log2 of the window length
+	FILTER_IIR,					// param: k, y += (x - y) / 2^k
+	FILTER_MEDIAN				// param: number of taps, 3 or 5
+} filter_type_t;
+
+// one stage of a filter chain, including its state
+typedef struct
+{
+	filter_type_t type;
+	uint8_t param;
+	uint8_t index;				// next history slot
+	uint8_t primed;				// set once the first sample is seen
+	int32_t state;				// running sum (average) or Q8 output (IIR)
+	int16_t history[FILTER_HISTORY_SIZE];
+} filter_stage_t;
+
+// chain of stages applied in order to one axis
+typedef struct
+{
+	uint8_t num_stages;
+	filter_stage_t stage[FILTER_MAX_STAGES];
+} filter_chain_t;
+
+/*****************************************************************************
+* Removes all stages from a chain, an empty chain passes samples through
+*
+* Parameters:
+*   chain			filter chain instance
+*
+*****************************************************************************/
+void filter_chain_init(filter_chain_t *chain);
+
+/*****************************************************************************
+* Appends a stage to the end of a chain
+*
+* Parameters:
+*   chain			filter chain instance
+*   type			stage type
+*   param			stage parameter, see filter_type_t
+*
+* Returns:
+*   1 if the stage was added, 0 if the chain is full or param is invalid
+*
+*****************************************************************************/
+int filter_chain_add(filter_chain_t *chain, filter_type_t type, uint8_t param);
+
+/*****************************************************************************
+* Clears the state of every stage, the next sample primes the chain again
+*
+* Parameters:
+*   chain			filter chain instance
+*
+*****************************************************************************/
+void filter_chain_reset(filter_chain_t *chain);
+
+/*****************************************************************************
+* Runs one sample through every stage of the chain
+*
+* Parameters:
+*   chain			filter chain instance
+*   sample			input sample
+*
+* Returns:
+*   filtered sample
+*
+*****************************************************************************/
+int16_t filter_chain_apply(filter_chain_t *chain, int16_t sample);
+
+#endif /* ACCEL_FILTER_H_ */
@@ -21,69 +21,120 @@
  *****************************************************************************/
 
 // including libraries
-#include <MKL25Z4.H>
+#include "MKL25Z4.h"
 #include "accelerometer.h"
 #include "i2c.h"
-#include <math.h>
-#include "fsl_debug_console.h"
+#include "calibration.h"
 #include <stdio.h>
 
 
-// macros
-#define ANGLE_RADIANS (180)
-#define LEFT_SHIFT_8 (8)
+// active driver
+const sensor_driver_t *sensor = &mma8451_sensor;
+
+// latest sample, double buffered: the writer only fills the slot that is
+// not published, then publishes it by incrementing the sequence
+static volatile sample_t snapshot[2];
+static volatile uint32_t snapshot_sequence = 0;
 
 // initializes mma8451 sensor
 int init_mma()
 {
-	// set active mode, 14 bit samples and 800 Hz ODR
-	i2c_write_byte(MMA_ADDR, REG_CTRL1, 0x01);
+	// loads and activates the sensor configuration
+	if (sensor->init() != I2C_OK)
+		return 0;
 	printf("MMA Initialized\r\n");
 	return 1;
 }
 
 void i2c_test()
 {
-	if(i2c_read_byte(MMA_ADDR, REG_WHOAMI) == WHOAMI)
+	uint8_t whoami;
+
+	if(i2c_bus_read(&mma_device, REG_WHOAMI, &whoami, 1) == I2C_OK && whoami == WHOAMI)
 	{
 		printf("I2C Testing Done\r\n");
 
 	}
 }
 
-// reads acceleorometer values and measure the roll angle
-int read_roll_angle()
+// function definition in header file
+i2c_status_t read_accel_raw(int16_t xyz[AXIS_COUNT])
 {
-	// initializing variables
-	int i, y_value, z_value;
-	int roll_angle;
-	uint8_t data_arr[6];
-	int16_t temp_arr[3];
-
-	// calling i2c
-	i2c_start();
-	i2c_read_setup(MMA_ADDR , REG_XHI);
-
-	// Read five bytes in repeated mode
-	for( i=0; i<5; i++)	{
-		data_arr[i] = i2c_repeated_read(0);
-	}
-	// Read last byte ending repeated mode
-	data_arr[i] = i2c_repeated_read(1);
+	return sensor->read_burst(xyz);
+}
 
-	// extracing 16 bits of data and storing in temp array
-	for ( i=0 ; i<3 ; i++ ) {
-		temp_arr[i] = (int16_t)((data_arr[2*i] << LEFT_SHIFT_8) | data_arr[2*i+1]);
-	}
+// function definition in header file
+i2c_status_t read_accel_xyz(int16_t xyz[AXIS_COUNT])
+{
+	i2c_status_t status = read_accel_raw(xyz);
 
-	// Align for 14 bits
-	y_value = temp_arr[0]/4;
-	z_value = temp_arr[2]/4;
+	if (status == I2C_OK)
+		calibration_apply(xyz);
+	return status;
+}
+
+// function definition in header file
+void publish_sample(const sample_t *sample)
+{
+	uint32_t next = snapshot_sequence + 1;
 
-	// roll angle measurement using inverse tan
-	roll_angle = atan2(y_value, z_value) * ANGLE_RADIANS /PI;
+	snapshot[next & 1] = *sample;
 
-	// return the roll angle
-	return roll_angle;
+	// the slot must be complete before it is published
+	__DMB();
+	snapshot_sequence = next;
 }
 
+// function definition in header file
+i2c_status_t read_sample(sample_t *sample)
+{
+	int16_t xyz[AXIS_COUNT];
+	i2c_status_t status = read_accel_xyz(xyz);
+
+	// a failed read leaves the sample untouched
+	if (status != I2C_OK)
+		return status;
+
+	// stamped as soon as the data is in, before any processing time
+	sample->timestamp_us = sensor->get_timestamp_us();
+	for (int i = 0; i < AXIS_COUNT; i++)
+		sample->raw[i] = xyz[i];
+	return I2C_OK;
+}
+
+// reads acceleorometer values and measure the roll angle
+i2c_status_t read_roll_angle(angle_t *roll, uint64_t *timestamp_us)
+{
+	int16_t xyz[AXIS_COUNT];
+	tilt_t tilt;
+	i2c_status_t status = read_accel_xyz(xyz);
+
+	if (status != I2C_OK)
+		return status;
+	if (timestamp_us)
+		*timestamp_us = sensor->get_timestamp_us();
+
+	// roll angle measurement using integer inverse tan, in centi-degrees
+	compute_tilt(xyz, &tilt);
+	*roll = tilt.roll;
+	return I2C_OK;
+}
+
+// function definition in header file
+uint32_t latest_sample(sample_t *sample)
+{
+	uint32_t sequence;
+
+	// copy again if a newer sample was published meanwhile, which only
+	// happens when the reader is interrupted by the writer
+	do {
+		sequence = snapshot_sequence;
+		if (sequence == 0)
+			return 0;
+		__DMB();
+		*sample = snapshot[sequence & 1];
+		__DMB();
+	} while (sequence != snapshot_sequence);
+
+	return sequence;
+}
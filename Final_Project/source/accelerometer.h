@@ -28,30 +28,110 @@
 #ifndef MMA8451_H
 #define MMA8451_H
 #include <stdint.h>
+#include "accel_filter.h"
+#include "i2c.h"
+#include "i2c_bus.h"
+#include "mma8451.h"
+#include "sensor.h"
+#include "tilt.h"
 
 
-// defining macros required for MMA initialization
-#define MMA_ADDR 	(0x3A)		// mma sensor address
-#define REG_XHI 	(0x01)		// xhi register address
-#define REG_CTRL1  	(0x2A)		// CTRL1 register address
-#define REG_WHOAMI 	(0x0D)		// who am i register for testing
-#define WHOAMI 		(0x1A)
+// one acquired sample, stamped with the sensor time base when it was read
+typedef struct
+{
+	uint64_t timestamp_us;		// microseconds, free running, never wraps
+	int16_t raw[AXIS_COUNT];	// calibrated counts before the filters
+	int16_t xyz[AXIS_COUNT];	// calibrated and filtered counts
+	tilt_t tilt;				// tilt computed from xyz
+} sample_t;
 
-#define PI (3.14159265)		// pi value
+// driver used by the functions below, the MMA8451 unless changed
+extern const sensor_driver_t *sensor;
 
 // function declarations
 
 /*****************************************************************************
- * Initializes the MMA sensor of KL25Z board
+ * Initializes the active sensor, the MMA8451 of the KL25Z board by default
+ *
+ * Returns:
+ *   1 on success, 0 otherwise
  *
  *****************************************************************************/
 int init_mma(void);
 
 /*****************************************************************************
- * Reads and returns the roll angle using trigonometry calculations
+ * Reads the X, Y and Z samples in one burst from the active sensor driver,
+ * without calibration
+ *
+ * Parameters:
+ *   xyz      	array of AXIS_COUNT 14 bit samples, filled by the function
+ *
+ * Returns:
+ *   I2C_OK, or the i2c error, in which case the output is not written
+ *
+ *****************************************************************************/
+i2c_status_t read_accel_raw(int16_t xyz[AXIS_COUNT]);
+
+/*****************************************************************************
+ * Reads one sample and applies the offset and gain calibration
+ *
+ * Parameters:
+ *   xyz      	array of AXIS_COUNT calibrated samples, filled by the function
+ *
+ * Returns:
+ *   I2C_OK, or the i2c error, in which case the output is not written
+ *
+ *****************************************************************************/
+i2c_status_t read_accel_xyz(int16_t xyz[AXIS_COUNT]);
+
+/*****************************************************************************
+ * Reads one sample and stamps it, the filters and the tilt are left to
+ * the pipeline (see pipeline.h)
+ *
+ * Parameters:
+ *   sample		timestamp and calibrated counts, xyz and tilt are not written
+ *
+ * Returns:
+ *   I2C_OK, or the i2c error, in which case the output is not written
+ *
+ *****************************************************************************/
+i2c_status_t read_sample(sample_t *sample);
+
+/*****************************************************************************
+ * Reads the roll angle using integer trigonometry, the sample
+ * is not filtered so it is safe to use outside of the main loop
+ *
+ * Parameters:
+ *   roll			roll angle in centi-degrees, range -18000 to 18000
+ *   timestamp_us	time of the sample, may be NULL
+ *
+ * Returns:
+ *   I2C_OK, or the i2c error, in which case the output is not written
+ *
+ *****************************************************************************/
+i2c_status_t read_roll_angle(angle_t *roll, uint64_t *timestamp_us);
+
+/*****************************************************************************
+ * Makes a processed sample visible to latest_sample()
+ *
+ * Parameters:
+ *   sample		sample to publish, copied
+ *
+ *****************************************************************************/
+void publish_sample(const sample_t *sample);
+
+/*****************************************************************************
+ * Copies the sample last published by publish_sample(), without any bus access.
+ * Lock free and safe from any context, including interrupt handlers
+ *
+ * Parameters:
+ *   sample		copy of the latest sample
+ *
+ * Returns:
+ *   sequence number of the sample, 0 if no sample was read yet
  *
  *****************************************************************************/
-int read_roll_angle(void);
+uint32_t latest_sample(sample_t *sample);
 
 /*****************************************************************************
  * Tests I2C communication to MMA sensor
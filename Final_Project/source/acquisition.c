@@ -0,0 +1,107 @@
+/*****************************************************************************
+* Copyright (C) 2022 by Bhargav Dharmendra Chauhan
+*
+* Redistribution, modification or use of this software in source or binary
+* forms is permitted as long as the files maintain this copyright. Users are
+* permitted to modify this and use it to learn about the field of embedded
+* software. Bhargav Dharmendra Chauhan and the University of Colorado
+* are not liable for any misuse of this material.
+*
+*****************************************************************************/
+/*****************************************************************************
+*
+*    File name   : acquisition.c
+*    Description : adaptive acquisition rate, follows the angular rate of
+*                  the board with hysteresis
+*
+*    Author: Bhargav Dharmendra Chauhan
+*    Tools : MCUXpresso
+*    Date  : 10/19/2026
+*
+*****************************************************************************/
+
+// including required libraries
+#include <stdint.h>
+#include "acquisition.h"
+#include "accelerometer.h"
+
+// one acquisition level
+typedef struct
+{
+	uint32_t period_us;			// sensor and loop sampling period
+	uint32_t enter_rate;		// cdeg/s, entered from below above this rate
+	uint32_t exit_rate;			// cdeg/s, left downwards below this rate
+} acquisition_level_t;
+
+static const acquisition_level_t levels[ACQUISITION_LEVELS] = {
+	{ 80000, 0, 0 },			// still, 12.5 Hz
+	{ 10000, 200, 100 },		// moving, 100 Hz, above 2 degree/s
+	{ 2500, 2000, 1000 },		// fast, 400 Hz, above 20 degree/s
+};
+
+// programs the sensor data rate of a level
+static void apply_level(acquisition_t *acquisition, uint8_t level)
+{
+	sensor_config_t config = { levels[level].period_us, SENSOR_KEEP, SENSOR_KEEP };
+
+	acquisition->level = level;
+	acquisition->calm_since_us = 0;
+	sensor->configure(&config);
+}
+
+// function definition in header file
+void acquisition_init(acquisition_t *acquisition, uint8_t level)
+{
+	acquisition->switches = 0;
+	apply_level(acquisition, level);
+}
+
+// function definition in header file
+int acquisition_update(acquisition_t *acquisition, int32_t rate, angle_t distance,
+		uint64_t now_us)
+{
+	uint32_t speed = (rate < 0) ? -rate : rate;
+	int near = (distance < 0 ? -distance : distance) < ACQUISITION_NEAR_TARGET;
+	uint8_t lowest = near ? ACQUISITION_MOVING : ACQUISITION_STILL;
+	uint8_t level = acquisition->level;
+	uint32_t exit_rate;
+
+	// lower thresholds near the target are the same as a faster rate
+	if (near)
+		speed <<= ACQUISITION_NEAR_SHIFT;
+
+	// up right away, as far as the rate requires
+	while (level + 1 < ACQUISITION_LEVELS && speed > levels[level + 1].enter_rate)
+		level++;
+	if (level < lowest)
+		level = lowest;
+
+	if (level != acquisition->level) {
+		apply_level(acquisition, level);
+		acquisition->switches++;
+		return 1;
+	}
+
+	// down one level once the rate stayed low for the hold time
+	exit_rate = levels[level].exit_rate;
+	if (level == lowest || speed >= exit_rate) {
+		acquisition->calm_since_us = 0;
+		return 0;
+	}
+	if (acquisition->calm_since_us == 0) {
+		acquisition->calm_since_us = now_us;
+		return 0;
+	}
+	if (now_us - acquisition->calm_since_us < ACQUISITION_HOLD_US)
+		return 0;
+
+	apply_level(acquisition, level - 1);
+	acquisition->switches++;
+	return 1;
+}
+
+// function definition in header file
+uint32_t acquisition_period_us(const acquisition_t *acquisition)
+{
+	return levels[acquisition->level].period_us;
+}
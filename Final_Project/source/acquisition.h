@@ -0,0 +1,88 @@
+/*****************************************************************************
+* Copyright (C) 2022 by Bhargav Dharmendra Chauhan
+*
+* Redistribution, modification or use of this software in source or binary
+* forms is permitted as long as the files maintain this copyright. Users are
+* permitted to modify this and use it to learn about the field of embedded
+* software. Bhargav Dharmendra Chauhan and the University of Colorado
+* are not liable for any misuse of this material.
+*
+*****************************************************************************/
+/*****************************************************************************
+*
+*    File name   : acquisition.h
+*    Description : adaptive acquisition rate, follows the angular rate of
+*                  the board with hysteresis
+*
+*    Author: Bhargav Dharmendra Chauhan
+*    Tools : MCUXpresso
+*    Date  : 10/19/2026
+*
+*    Three levels: still (12.5 Hz), moving (100 Hz) and fast (400 Hz). A
+*    level is entered as soon as the rate exceeds its entry threshold, and
+*    left only after the rate stayed below its lower exit threshold for
+*    ACQUISITION_HOLD_US. Near the target the thresholds are lowered and
+*    the still level is not used, so the final approach is sampled fast.
+*
+*****************************************************************************/
+
+#ifndef ACQUISITION_H_
+#define ACQUISITION_H_
+
+#include <stdint.h>
+#include "tilt.h"
+
+#define ACQUISITION_STILL 		(0)
+#define ACQUISITION_MOVING 		(1)
+#define ACQUISITION_FAST 		(2)
+#define ACQUISITION_LEVELS 		(3)
+
+#define ACQUISITION_HOLD_US 	(500000)	// calm time before stepping down
+#define ACQUISITION_NEAR_TARGET (500)		// cdeg, the target is close
+#define ACQUISITION_NEAR_SHIFT 	(2)			// thresholds / 4 near the target
+
+// state of the controller
+typedef struct
+{
+	uint8_t level;				// current ACQUISITION_* level
+	uint64_t calm_since_us;		// rate below the exit threshold since, 0 if not
+	uint32_t switches;			// level changes since acquisition_init()
+} acquisition_t;
+
+/*****************************************************************************
+* Starts the controller at a level and configures the active sensor for it
+*
+* Parameters:
+*   acquisition		controller instance
+*   level			initial ACQUISITION_* level
+*
+*****************************************************************************/
+void acquisition_init(acquisition_t *acquisition, uint8_t level);
+
+/*****************************************************************************
+* Updates the level from the latest estimate, reconfiguring the sensor data
+* rate when it changes
+*
+* Parameters:
+*   acquisition		controller instance
+*   rate			angular rate, cdeg/s
+*   distance		distance of the angle to the target, cdeg
+*   now_us			time of the sample
+*
+* Returns:
+*   1 if the level changed, 0 otherwise
+*
+*****************************************************************************/
+int acquisition_update(acquisition_t *acquisition, int32_t rate, angle_t distance,
+		uint64_t now_us);
+
+/*****************************************************************************
+* Returns the sampling period of the current level in microseconds
+*
+* Parameters:
+*   acquisition		controller instance
+*
+*****************************************************************************/
+uint32_t acquisition_period_us(const acquisition_t *acquisition);
+
+#endif /* ACQUISITION_H_ */
@@ -0,0 +1,131 @@
+/*****************************************************************************
+* Copyright (C) 2022 by Bhargav Dharmendra Chauhan
+*
+* Redistribution, modification or use of this software in source or binary
+* forms is permitted as long as the files maintain this copyright. Users are
+* permitted to modify this and use it to learn about the field of embedded
+* software. Bhargav Dharmendra Chauhan and the University of Colorado
+* are not liable for any misuse of this material.
+*
+*****************************************************************************/
+/*****************************************************************************
+*
+*    File name   : angle_estimator.c
+*    Description : fixed-point alpha-beta estimator tracking an angle and
+*                  its angular rate
+*
+*    Author: Bhargav Dharmendra Chauhan
+*    Tools : MCUXpresso
+*    Date  : 10/19/2026
+*
+*    References:
+*    Kalata, "The Tracking Index: A Generalized Parameter for alpha-beta and
+*    alpha-beta-gamma Target Trackers", IEEE Trans. AES, 1984
+*
+*****************************************************************************/
+
+// including required libraries
+#include <stdint.h>
+#include "angle_estimator.h"
+#include "fp_math.h"
+
+#define STATE_SHIFT 		(8)			// state is kept in Q8
+#define GAIN_SHIFT 			(16)		// gains are in Q16
+#define INV_DT_SHIFT 		(10)		// 1/dt is in Q10
+#define US_PER_SECOND 		(1000000U)
+#define US_TO_S_MUL 		(4295ULL)	// 2^32 / 10^6, multiply-shift for /10^6
+#define US_TO_S_SHIFT 		(32)
+#define ANGLE_WRAP 			((int32_t)CDEG_180 << STATE_SHIFT)
+#define FULL_TURN 			(2 * ANGLE_WRAP)
+
+// brings an angle in Q8 centi-degrees back to -180..180 degrees
+static int32_t wrap_angle(int32_t angle)
+{
+	if (angle > ANGLE_WRAP)
+		angle -= FULL_TURN;
+	else if (angle < -ANGLE_WRAP)
+		angle += FULL_TURN;
+	return angle;
+}
+
+// function definition in header file
+void angle_estimator_init(angle_estimator_t *estimator, uint32_t process_noise,
+		uint32_t measurement_noise, uint32_t dt_us)
+{
+	uint64_t index, root, r, one_minus_alpha;
+	uint32_t alpha, beta;
+
+	// tracking index: process_noise * dt^2 / measurement_noise, in Q16
+	if (measurement_noise == 0)
+		measurement_noise = 1;
+	index = ((uint64_t)process_noise * dt_us / US_PER_SECOND) * dt_us;
+	index = (index << GAIN_SHIFT) / US_PER_SECOND / measurement_noise;
+
+	// r = (4 + index - sqrt(8 * index + index^2)) / 4
+	root = fp_isqrt64((8 * index << GAIN_SHIFT) + index * index);
+	r = ((4ULL << GAIN_SHIFT) + index - root) / 4;
+
+	// alpha = 1 - r^2, beta = 2 * (2 - alpha) - 4 * sqrt(1 - alpha)
+	alpha = ESTIMATOR_GAIN_ONE - (uint32_t)((r * r) >> GAIN_SHIFT);
+	one_minus_alpha = ESTIMATOR_GAIN_ONE - alpha;
+	beta = 2 * (2 * ESTIMATOR_GAIN_ONE - alpha)
+			- 4 * fp_isqrt64(one_minus_alpha << GAIN_SHIFT);
+
+	angle_estimator_set_gains(estimator, alpha, beta);
+	estimator->dt_us = 0;
+	estimator->primed = 0;
+}
+
+// function definition in header file
+void angle_estimator_set_gains(angle_estimator_t *estimator, uint32_t alpha,
+		uint32_t beta)
+{
+	estimator->alpha = alpha;
+	estimator->beta = beta;
+}
+
+// function definition in header file
+angle_t angle_estimator_update(angle_estimator_t *estimator, angle_t measurement,
+		uint32_t dt_us)
+{
+	int32_t measured = measurement << STATE_SHIFT;
+	int32_t predicted, residual;
+
+	// the first measurement is taken as is, at rest
+	if (!estimator->primed || dt_us == 0) {
+		if (!estimator->primed) {
+			estimator->angle = measured;
+			estimator->rate = 0;
+			estimator->primed = 1;
+		}
+		return estimator->angle >> STATE_SHIFT;
+	}
+
+	// the reciprocal of the period is only recomputed when the period changes
+	if (dt_us != estimator->dt_us) {
+		estimator->dt_us = dt_us;
+		estimator->inv_dt = (US_PER_SECOND << INV_DT_SHIFT) / dt_us;
+	}
+
+	// predict: angle += rate * dt
+	predicted = estimator->angle
+			+ (int32_t)(((int64_t)estimator->rate * dt_us * US_TO_S_MUL) >> US_TO_S_SHIFT);
+	predicted = wrap_angle(predicted);
+
+	// shortest way from the prediction to the measurement
+	residual = wrap_angle(measured - predicted);
+
+	// correct: angle += alpha * residual, rate += beta * residual / dt
+	estimator->angle = wrap_angle(predicted
+			+ (int32_t)(((int64_t)estimator->alpha * residual) >> GAIN_SHIFT));
+	estimator->rate += (int32_t)(((((int64_t)estimator->beta * residual) >> GAIN_SHIFT)
+			* estimator->inv_dt) >> INV_DT_SHIFT);
+
+	return estimator->angle >> STATE_SHIFT;
+}
+
+// function definition in header file
+int32_t angle_estimator_rate(const angle_estimator_t *estimator)
+{
+	return estimator->rate >> STATE_SHIFT;
+}
@@ -0,0 +1,96 @@
+/*****************************************************************************
+* Copyright (C) 2022 by Bhargav Dharmendra Chauhan
+*
+* Redistribution, modification or use of this software in source or binary
+* forms is permitted as long as the files maintain this copyright. Users are
+* permitted to modify this and use it to learn about the field of embedded
+* software. Bhargav Dharmendra Chauhan and the University of Colorado
+* are not liable for any misuse of this material.
+*
+*****************************************************************************/
+/*****************************************************************************
+*
+*    File name   : angle_estimator.h
+*    Description : fixed-point alpha-beta estimator tracking an angle and
+*                  its angular rate
+*
+*    Author: Bhargav Dharmendra Chauhan
+*    Tools : MCUXpresso
+*    Date  : 10/19/2026
+*
+*    The gains are the steady state gains of the two state (angle, rate)
+*    Kalman filter with a constant acceleration noise model, so the filter
+*    is tuned with noise figures instead of raw gains.
+*
+*****************************************************************************/
+
+#ifndef ANGLE_ESTIMATOR_H_
+#define ANGLE_ESTIMATOR_H_
+
+#include <stdint.h>
+#include "tilt.h"
+
+#define ESTIMATOR_GAIN_ONE 	(1UL << 16)		// gains are in Q16
+
+// estimator state
+typedef struct
+{
+	int32_t angle;			// estimated angle, centi-degrees in Q8
+	int32_t rate;			// estimated rate, centi-degrees per second in Q8
+	uint32_t alpha;			// angle gain, Q16
+	uint32_t beta;			// rate gain, Q16
+	uint32_t dt_us;			// sample period of the cached reciprocal
+	uint32_t inv_dt;		// 1/dt in Q10 per second
+	uint8_t primed;			// set once the first measurement is seen
+} angle_estimator_t;
+
+/*****************************************************************************
+* Initializes an estimator and computes its gains from noise figures
+*
+* Parameters:
+*   estimator				estimator instance
+*   process_noise			expected angular acceleration, cdeg/s^2
+*   measurement_noise		standard deviation of the input angle, cdeg
+*   dt_us					nominal sample period in microseconds
+*
+*****************************************************************************/
+void angle_estimator_init(angle_estimator_t *estimator, uint32_t process_noise,
+		uint32_t measurement_noise, uint32_t dt_us);
+
+/*****************************************************************************
+* Overrides the gains computed by angle_estimator_init()
+*
+* Parameters:
+*   estimator		estimator instance
+*   alpha			angle gain in Q16, 0 to ESTIMATOR_GAIN_ONE
+*   beta			rate gain in Q16, 0 to 2 * ESTIMATOR_GAIN_ONE
+*
+*****************************************************************************/
+void angle_estimator_set_gains(angle_estimator_t *estimator, uint32_t alpha,
+		uint32_t beta);
+
+/*****************************************************************************
+* Predicts the state over dt_us and corrects it with a new measurement
+*
+* Parameters:
+*   estimator		estimator instance
+*   measurement		measured angle in centi-degrees
+*   dt_us			time since the previous measurement in microseconds
+*
+* Returns:
+*   estimated angle in centi-degrees
+*
+*****************************************************************************/
+angle_t angle_estimator_update(angle_estimator_t *estimator, angle_t measurement,
+		uint32_t dt_us);
+
+/*****************************************************************************
+* Returns the estimated angular rate in centi-degrees per second
+*
+* Parameters:
+*   estimator		estimator instance
+*
+*****************************************************************************/
+int32_t angle_estimator_rate(const angle_estimator_t *estimator);
+
+#endif /* ANGLE_ESTIMATOR_H_ */
@@ -0,0 +1,379 @@
+/*****************************************************************************
+* Copyright (C) 2022 by Bhargav Dharmendra Chauhan
+*
+* Redistribution, modification or use of this software in source or binary
+* forms is permitted as long as the files maintain this copyright. Users are
+* permitted to modify this and use it to learn about the field of embedded
+* software. Bhargav Dharmendra Chauhan and the University of Colorado
+* are not liable for any misuse of this material.
+*
+*****************************************************************************/
+/*****************************************************************************
+*
+*    File name   : benchmark.c
+*    Description : on target cycle benchmarks of the processing stages
+*
+*    Author: Bhargav Dharmendra Chauhan
+*    Tools : MCUXpresso
+*    Date  : 10/19/2026
+*
+*****************************************************************************/
+
+// including required libraries
+#include <stdint.h>
+#include <stdio.h>
+#include "benchmark.h"
+#include "cycles.h"
+#include "accel_filter.h"
+#include "angle_estimator.h"
+#include "fp_math.h"
+#include "i2c.h"
+#include "accelerometer.h"
+#include "mma8451.h"
+#include "timebase.h"
+#include "uart.h"
+
+#define BENCHMARK_SAMPLES 	(256)
+#define NOISE_MASK 			(0x3F)		// +/-32 counts of noise
+#define NOISE_OFFSET 		(32)
+#define SAMPLE_BASE 		(4096)		// 1g on the +/-2g range
+
+// estimator replay: 2 s at 100 Hz, 30 degree step after 0.5 s
+#define REPLAY_SAMPLES 		(200)
+#define REPLAY_PERIOD_US 	(10000)
+#define REPLAY_STEP_INDEX 	(50)
+#define REPLAY_STEP_ANGLE 	(3000)
+#define REPLAY_NOISE_MASK 	(0x7F)		// +/-0.64 degree of input noise
+#define REPLAY_NOISE_OFFSET (64)
+#define REPLAY_SETTLE_BAND 	(100)		// settled within +/-1 degree
+#define REPLAY_STEADY_INDEX (150)		// noise is measured over the last 0.5 s
+#define REPLAY_PROCESS_NOISE (20000)	// cdeg/s^2
+#define REPLAY_MEAS_NOISE 	(37)		// cdeg, standard deviation of the noise
+#define REPLAY_IIR_SHIFT 	(4)			// heavy low pass used for comparison
+
+#define I2C_BENCHMARK_READS (32)		// sample reads timed per speed
+
+#define MODE_SETTLE_SAMPLES (4)			// discarded after a mode change
+#define MODE_SAMPLES 		(64)		// samples per noise measurement
+#define MICRO_G_SQUARED 	(59605)		// (1000000 / COUNTS_PER_G)^2, ug^2 per count^2
+
+#define UART_LINES 			(8)			// lines sent per transmit mode
+#define UART_CALIBRATION_US (100000)	// idle run of the polling loop
+#define UART_LINE 			"[123456 ms] Roll angle from reference is 12.34 degree, pitch -1.23\n\r"
+
+// one filter stage under test
+typedef struct
+{
+	const char *name;
+	filter_type_t type;
+	uint8_t param;
+	uint32_t budget;
+} filter_benchmark_t;
+
+static const filter_benchmark_t filter_benchmarks[] = {
+	{ "moving average 8", FILTER_MOVING_AVERAGE, 3, BUDGET_MOVING_AVERAGE },
+	{ "iir 1/8", FILTER_IIR, 3, BUDGET_IIR },
+	{ "median 3", FILTER_MEDIAN, 3, BUDGET_MEDIAN3 },
+	{ "median 5", FILTER_MEDIAN, 5, BUDGET_MEDIAN5 },
+};
+
+// synthetic noisy samples, same sequence for every stage
+static int16_t samples[BENCHMARK_SAMPLES];
+
+// fills the sample buffer with a fixed pseudo random sequence
+static void generate_samples(void)
+{
+	uint32_t seed = 1;
+
+	for (int i = 0; i < BENCHMARK_SAMPLES; i++) {
+		// linear congruential generator
+		seed = seed * 1664525U + 1013904223U;
+		samples[i] = SAMPLE_BASE + (int16_t)((seed >> 24) & NOISE_MASK) - NOISE_OFFSET;
+	}
+}
+
+// cycles taken to run every sample through a chain
+static uint32_t run_chain(filter_chain_t *chain)
+{
+	volatile int16_t output;
+	uint32_t start = cycles_now();
+
+	for (int i = 0; i < BENCHMARK_SAMPLES; i++)
+		output = filter_chain_apply(chain, samples[i]);
+
+	(void)output;
+	return cycles_since(start);
+}
+
+// function definition in header file
+void benchmark_filters(void)
+{
+	filter_chain_t chain;
+	uint32_t overhead, cycles, per_sample;
+
+	generate_samples();
+	cycles_init();
+
+	// loop and call cost measured with an empty chain
+	filter_chain_init(&chain);
+	overhead = run_chain(&chain);
+
+	printf("Filter benchmark, cycles per sample:\n\r");
+	for (int i = 0; i < sizeof(filter_benchmarks) / sizeof(filter_benchmarks[0]); i++) {
+		const filter_benchmark_t *bench = &filter_benchmarks[i];
+
+		filter_chain_init(&chain);
+		filter_chain_add(&chain, bench->type, bench->param);
+		cycles = run_chain(&chain);
+		per_sample = (cycles > overhead ? cycles - overhead : 0) / BENCHMARK_SAMPLES;
+
+		printf("\t%s: %d (budget %d) %s\n\r", bench->name, (int)per_sample,
+				(int)bench->budget, per_sample <= bench->budget ? "OK" : "OVER BUDGET");
+	}
+}
+
+// settling and noise figures of one output trace
+typedef struct
+{
+	int32_t settle_index;		// first sample after which the output stays in band
+	uint32_t noise_rms;			// rms error over the steady part, cdeg
+} replay_result_t;
+
+// updates the figures of a trace with the output of one sample
+static void replay_track(replay_result_t *result, int index, angle_t output,
+		angle_t truth, uint64_t *square_sum)
+{
+	angle_t error = output - truth;
+
+	// settling restarts every time the output leaves the band
+	if (index >= REPLAY_STEP_INDEX
+			&& (error > REPLAY_SETTLE_BAND || error < -REPLAY_SETTLE_BAND))
+		result->settle_index = index + 1;
+
+	if (index >= REPLAY_STEADY_INDEX)
+		*square_sum += (int64_t)error * error;
+}
+
+// prints the figures of one trace
+static void replay_print(const char *name, const replay_result_t *result)
+{
+	printf("\t%s: settles in %d ms, noise %d.%02d degree rms\n\r", name,
+			(int)((result->settle_index - REPLAY_STEP_INDEX) * (REPLAY_PERIOD_US / 1000)),
+			(int)(result->noise_rms / CDEG_PER_DEGREE),
+			(int)(result->noise_rms % CDEG_PER_DEGREE));
+}
+
+// function definition in header file
+void benchmark_estimator(void)
+{
+	angle_estimator_t estimator;
+	filter_chain_t low_pass;
+	replay_result_t raw = { REPLAY_STEP_INDEX, 0 };
+	replay_result_t estimated = { REPLAY_STEP_INDEX, 0 };
+	replay_result_t filtered = { REPLAY_STEP_INDEX, 0 };
+	uint64_t raw_sum = 0, estimated_sum = 0, filtered_sum = 0;
+	uint32_t seed = 1;
+	angle_t truth, measurement;
+
+	angle_estimator_init(&estimator, REPLAY_PROCESS_NOISE, REPLAY_MEAS_NOISE,
+			REPLAY_PERIOD_US);
+	filter_chain_init(&low_pass);
+	filter_chain_add(&low_pass, FILTER_IIR, REPLAY_IIR_SHIFT);
+
+	for (int i = 0; i < REPLAY_SAMPLES; i++) {
+		// noisy step, like read_roll_angle() output on a moved fixture
+		truth = (i < REPLAY_STEP_INDEX) ? 0 : REPLAY_STEP_ANGLE;
+		seed = seed * 1664525U + 1013904223U;
+		measurement = truth + (angle_t)((seed >> 24) & REPLAY_NOISE_MASK) - REPLAY_NOISE_OFFSET;
+
+		replay_track(&raw, i, measurement, truth, &raw_sum);
+		replay_track(&estimated, i,
+				angle_estimator_update(&estimator, measurement, REPLAY_PERIOD_US),
+				truth, &estimated_sum);
+		replay_track(&filtered, i, filter_chain_apply(&low_pass, measurement),
+				truth, &filtered_sum);
+	}
+
+	raw.noise_rms = fp_isqrt64(raw_sum / (REPLAY_SAMPLES - REPLAY_STEADY_INDEX));
+	estimated.noise_rms = fp_isqrt64(estimated_sum / (REPLAY_SAMPLES - REPLAY_STEADY_INDEX));
+	filtered.noise_rms = fp_isqrt64(filtered_sum / (REPLAY_SAMPLES - REPLAY_STEADY_INDEX));
+
+	printf("Estimator replay, %d degree step at %d Hz:\n\r",
+			REPLAY_STEP_ANGLE / CDEG_PER_DEGREE, (int)(1000000 / REPLAY_PERIOD_US));
+	replay_print("raw", &raw);
+	replay_print("estimator", &estimated);
+	replay_print("iir 1/16", &filtered);
+}
+
+// function definition in header file
+void benchmark_i2c_speeds(void)
+{
+	static const uint32_t speeds[] = { I2C_SPEED_STANDARD, I2C_SPEED_FAST, I2C_SPEED_MAX };
+	i2c_device_t previous = mma_device;
+	uint32_t cycles, start;
+	int16_t xyz[AXIS_COUNT];
+
+	cycles_init();
+	printf("I2C benchmark, time per 6 byte sample read:\n\r");
+
+	for (int i = 0; i < sizeof(speeds) / sizeof(speeds[0]); i++) {
+		// the MMA8451 is rated for fast mode, fast mode plus is not tried on it
+		if (speeds[i] > previous.max_hz) {
+			printf("\trequested %d Hz, above the %d Hz device rating\n\r", (int)speeds[i],
+					(int)previous.max_hz);
+			continue;
+		}
+
+		// the device handle selects the rate of every read
+		i2c_bus_device_speed(&mma_device, speeds[i]);
+
+		start = cycles_now();
+		for (int read = 0; read < I2C_BENCHMARK_READS; read++)
+			read_accel_raw(xyz);
+		cycles = cycles_since(start) / I2C_BENCHMARK_READS;
+
+		printf("\trequested %d Hz, achieved %d Hz: %d us\n\r", (int)speeds[i],
+				(int)mma_device.speed_hz, (int)(cycles / CYCLES_PER_US));
+	}
+
+	mma_device = previous;
+}
+
+// sensor modes compared by benchmark_sensor_modes()
+static const mma_mode_t sensor_modes[] = {
+	{ MMA_ODR_800HZ, MMA_MODS_NORMAL, 0 },
+	{ MMA_ODR_100HZ, MMA_MODS_NORMAL, 0 },
+	{ MMA_ODR_100HZ, MMA_MODS_NORMAL, 1 },
+	{ MMA_ODR_100HZ, MMA_MODS_LOW_NOISE_LOW_POWER, 1 },
+	{ MMA_ODR_100HZ, MMA_MODS_HIGH_RESOLUTION, 1 },
+	{ MMA_ODR_100HZ, MMA_MODS_LOW_POWER, 0 },
+	{ MMA_ODR_12_5HZ, MMA_MODS_HIGH_RESOLUTION, 1 },
+};
+
+static const char *mods_names[MMA_MODS_COUNT] = { "normal", "low noise low power",
+		"high resolution", "low power" };
+
+// waits for a new sample and reads it, bounded by two sample periods
+static i2c_status_t read_next_sample(uint32_t period_us, int16_t xyz[AXIS_COUNT])
+{
+	uint64_t start = timebase_now_us();
+	uint8_t status = 0;
+
+	while (!(status & STATUS_ZYXDR)) {
+		if (i2c_bus_read(&mma_device, REG_STATUS, &status, 1) != I2C_OK
+				|| timebase_now_us() - start > 2 * period_us)
+			return I2C_ERR_TIMEOUT;
+	}
+	return read_accel_raw(xyz);
+}
+
+// function definition in header file
+void benchmark_sensor_modes(void)
+{
+	mma_mode_t previous;
+	int16_t xyz[AXIS_COUNT];
+	int32_t sum[AXIS_COUNT];
+	int64_t square_sum[AXIS_COUNT];
+	uint32_t noise_ug[AXIS_COUNT];
+	uint32_t period_us;
+	int sample, axis;
+
+	mma_get_mode(&previous);
+	printf("Sensor mode characterization, keep the board still:\n\r");
+
+	for (int i = 0; i < sizeof(sensor_modes) / sizeof(sensor_modes[0]); i++) {
+		const mma_mode_t *mode = &sensor_modes[i];
+
+		period_us = mma_odr_period_us(mode->odr);
+		if (mma_set_mode(mode) != I2C_OK) {
+			printf("\tmode change failed\n\r");
+			continue;
+		}
+
+		for (axis = 0; axis < AXIS_COUNT; axis++) {
+			sum[axis] = 0;
+			square_sum[axis] = 0;
+		}
+
+		// the first samples after a change still use the old settings
+		for (sample = -MODE_SETTLE_SAMPLES; sample < MODE_SAMPLES; sample++) {
+			if (read_next_sample(period_us, xyz) != I2C_OK)
+				break;
+			if (sample < 0)
+				continue;
+			for (axis = 0; axis < AXIS_COUNT; axis++) {
+				sum[axis] += xyz[axis];
+				square_sum[axis] += (int32_t)xyz[axis] * xyz[axis];
+			}
+		}
+		if (sample < MODE_SAMPLES) {
+			printf("\tsample read failed\n\r");
+			continue;
+		}
+
+		// standard deviation from n * sum(x^2) - sum(x)^2 = n^2 * variance
+		for (axis = 0; axis < AXIS_COUNT; axis++) {
+			int64_t scaled_variance = MODE_SAMPLES * square_sum[axis]
+					- (int64_t)sum[axis] * sum[axis];
+			noise_ug[axis] = fp_isqrt64((uint64_t)scaled_variance * MICRO_G_SQUARED)
+					/ MODE_SAMPLES;
+		}
+
+		printf("\t%d.%02d Hz %s%s, x%d oversampling: noise x %d y %d z %d ug rms,"
+				" ~%d uA\n\r", (int)(1000000 / period_us), (int)(100000000 / period_us % 100),
+				mods_names[mode->mods], mode->low_noise ? " + lnoise" : "",
+				(int)mma_oversampling(mode), (int)noise_ug[AXIS_X], (int)noise_ug[AXIS_Y],
+				(int)noise_ug[AXIS_Z], (int)mma_mode_current_ua(mode));
+	}
+
+	mma_set_mode(&previous);
+}
+
+// polling loop, runs for duration_us, or until the uart output is sent
+// when duration_us is 0. Both cases execute the same instructions
+static uint32_t poll_uart(uint32_t duration_us, uint32_t *elapsed_us)
+{
+	uint64_t start = timebase_now_us(), now;
+	uint32_t iterations = 0;
+	size_t pending;
+
+	do {
+		iterations++;
+		pending = uart_tx_pending();
+		now = timebase_now_us();
+	} while (duration_us ? now - start < duration_us : pending != 0);
+
+	*elapsed_us = (uint32_t)(now - start);
+	return iterations;
+}
+
+// function definition in header file
+void benchmark_uart_tx(void)
+{
+	static const char line[] = UART_LINE;
+	uint32_t idle_iterations, idle_us, iterations, elapsed_us, lost_us;
+	int32_t line_lost_us;
+
+	printf("UART transmit benchmark, CPU time per %d byte line:\n\r",
+			(int)(sizeof(line) - 1));
+
+	for (int dma = 0; dma <= 1; dma++) {
+		// also waits for the previous output
+		uart_tx_dma(dma);
+		idle_iterations = poll_uart(UART_CALIBRATION_US, &idle_us);
+
+		lost_us = 0;
+		for (int i = 0; i < UART_LINES; i++) {
+			uart_write((const uint8_t *)line, sizeof(line) - 1);
+			iterations = poll_uart(0, &elapsed_us);
+			// the idle rate is an average, a line may poll slightly faster
+			line_lost_us = (int32_t)(elapsed_us - (uint32_t)((uint64_t)iterations * idle_us
+					/ idle_iterations));
+			if (line_lost_us > 0)
+				lost_us += line_lost_us;
+		}
+
+		printf("\t%s: %d us\n\r", dma ? "dma, one interrupt per span"
+				: "one interrupt per character", (int)(lost_us / UART_LINES));
+	}
+}
@@ -0,0 +1,77 @@
+/*****************************************************************************
+* Copyright (C) 2022 by Bhargav Dharmendra Chauhan
+*
+* Redistribution, modification or use of this software in source or binary
+* forms is permitted as long as the files maintain this copyright. Users are
+* permitted to modify this and use it to learn about the field of embedded
+* software. Bhargav Dharmendra Chauhan and the University of Colorado
+* are not liable for any misuse of this material.
+*
+*****************************************************************************/
+/*****************************************************************************
+*
+*    File name   : benchmark.h
+*    Description : on target cycle benchmarks of the processing stages,
+*                  results are printed over the uart
+*
+*    Author: Bhargav Dharmendra Chauhan
+*    Tools : MCUXpresso
+*    Date  : 10/19/2026
+*
+*    Define RUN_BENCHMARKS to run them from main() at start up
+*
+*****************************************************************************/
+
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+
+// cycle budget per sample and per axis of each filter stage
+#define BUDGET_MOVING_AVERAGE 	(150)
+#define BUDGET_IIR 				(100)
+#define BUDGET_MEDIAN3 			(150)
+#define BUDGET_MEDIAN5 			(400)
+
+/*****************************************************************************
+* Measures the cycles spent per sample by every filter stage and compares
+* them with their budget
+*
+*****************************************************************************/
+void benchmark_filters(void);
+
+/*****************************************************************************
+* Replays a synthetic noisy step of the roll angle through the angle
+* estimator and reports its settling time and noise next to the raw
+* read_roll_angle() style input and a heavy IIR low pass. host/estimator_host.c
+* makes the same comparison on a host, also on recorded traces
+*
+*****************************************************************************/
+void benchmark_estimator(void);
+
+/*****************************************************************************
+* Measures the time of one 6 byte sample read at standard, fast and maximum
+* SCL rates, those above the device rating are skipped, then restores the
+* rate that was in use
+*
+*****************************************************************************/
+void benchmark_i2c_speeds(void);
+
+/*****************************************************************************
+* Measures the sample noise of the sensor in several data rate and
+* oversampling modes, next to their estimated supply current, so hardware
+* oversampling can be weighed against the software filters. The board must
+* be kept still, the previous mode is restored afterwards
+*
+*****************************************************************************/
+void benchmark_sensor_modes(void);
+
+/*****************************************************************************
+* Measures the CPU time taken by the transmission of a status line, with
+* one interrupt per character and with the DMA transmit path. A polling
+* loop counts its iterations while the line is sent, the time it lost
+* against an idle calibration run is the time spent in the handlers.
+* Leaves the DMA transmit path enabled
+*
+*****************************************************************************/
+void benchmark_uart_tx(void);
+
+#endif /* BENCHMARK_H_ */
@@ -0,0 +1,204 @@
+/*****************************************************************************
+* Copyright (C) 2022 by Bhargav Dharmendra Chauhan
+*
+* Redistribution, modification or use of this software in source or binary
+* forms is permitted as long as the files maintain this copyright. Users are
+* permitted to modify this and use it to learn about the field of embedded
+* software. Bhargav Dharmendra Chauhan and the University of Colorado
+* are not liable for any misuse of this material.
+*
+*****************************************************************************/
+/*****************************************************************************
+*
+*    File name   : calibration.c
+*    Description : per axis offset and gain calibration of the MMA8451,
+*                  stored in the last flash sector
+*
+*    Author: Bhargav Dharmendra Chauhan
+*    Tools : MCUXpresso
+*    Date  : 10/19/2026
+*
+*****************************************************************************/
+
+// including required libraries
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "MKL25Z4.h"
+#include "fsl_flash.h"
+#include "calibration.h"
+
+// the last sector of the flash is kept for the calibration, PROGRAM_FLASH of
+// the project memory configuration (.cproject) ends below it
+#define CALIBRATION_SECTOR_SIZE 	(FSL_FEATURE_FLASH_PFLASH_BLOCK_SECTOR_SIZE)
+#define CALIBRATION_ADDRESS 		(FSL_FEATURE_FLASH_PFLASH_BLOCK_SIZE - CALIBRATION_SECTOR_SIZE)
+#define CALIBRATION_MAGIC 			(0x43414C31)	// "CAL1"
+
+#define CALIBRATION_SAMPLES_SHIFT 	(6)				// 64 samples per orientation
+#define CALIBRATION_SAMPLES 		(1 << CALIBRATION_SAMPLES_SHIFT)
+#define CALIBRATION_READ_RETRIES 	(8)				// failed reads tolerated per orientation
+#define CARRIAGE_RETURN 			(13)
+#define INT16_LIMIT 				(32767)
+
+// active calibration, identity by default
+calibration_t accel_calibration = {
+	CALIBRATION_MAGIC,
+	{ 0, 0, 0 },
+	{ CALIBRATION_SCALE_ONE, CALIBRATION_SCALE_ONE, CALIBRATION_SCALE_ONE },
+	0
+};
+
+static const char *axis_names[AXIS_COUNT] = { "X", "Y", "Z" };
+
+// checksum of every word of the record before the checksum field
+static uint32_t calibration_checksum(const calibration_t *calibration)
+{
+	const uint32_t *word = (const uint32_t *)calibration;
+	uint32_t checksum = 0;
+
+	for (int i = 0; i < offsetof(calibration_t, checksum) / sizeof(uint32_t); i++)
+		checksum = (checksum << 1 | checksum >> 31) ^ word[i];
+	return ~checksum;
+}
+
+// writes a calibration record to the reserved flash sector
+static int calibration_store(calibration_t *calibration)
+{
+	flash_config_t flash;
+	status_t status;
+	uint32_t interrupt_mask;
+
+	if (FLASH_Init(&flash) != kStatus_FLASH_Success)
+		return 0;
+
+	// vectors live in flash, nothing may run from it while it is busy
+	interrupt_mask = __get_PRIMASK();
+	__disable_irq();
+	status = FLASH_Erase(&flash, CALIBRATION_ADDRESS, CALIBRATION_SECTOR_SIZE,
+			kFLASH_ApiEraseKey);
+	if (status == kStatus_FLASH_Success)
+		status = FLASH_Program(&flash, CALIBRATION_ADDRESS, (uint32_t *)calibration,
+				sizeof(calibration_t));
+	__set_PRIMASK(interrupt_mask);
+
+	return status == kStatus_FLASH_Success;
+}
+
+// averages raw samples taken while the board is held still, gives up
+// with the error of the last read when the bus keeps failing
+static i2c_status_t average_raw_samples(int32_t average[AXIS_COUNT])
+{
+	int16_t xyz[AXIS_COUNT];
+	int32_t sum[AXIS_COUNT] = { 0, 0, 0 };
+	int retries = CALIBRATION_READ_RETRIES;
+	i2c_status_t status;
+
+	for (int i = 0; i < CALIBRATION_SAMPLES; i++) {
+		// a failed read is retried, it does not count as a sample
+		while ((status = read_accel_raw(xyz)) != I2C_OK) {
+			if (retries-- == 0)
+				return status;
+		}
+		for (int axis = 0; axis < AXIS_COUNT; axis++)
+			sum[axis] += xyz[axis];
+	}
+	for (int axis = 0; axis < AXIS_COUNT; axis++)
+		average[axis] = sum[axis] >> CALIBRATION_SAMPLES_SHIFT;
+	return I2C_OK;
+}
+
+// function definition in header file
+void calibration_apply(int16_t xyz[AXIS_COUNT])
+{
+	for (int axis = 0; axis < AXIS_COUNT; axis++) {
+		int32_t value = ((int32_t)(xyz[axis] - accel_calibration.offset[axis])
+				* accel_calibration.scale[axis]) >> CALIBRATION_SCALE_SHIFT;
+
+		// saturate instead of wrapping around
+		if (value > INT16_LIMIT)
+			value = INT16_LIMIT;
+		else if (value < -INT16_LIMIT)
+			value = -INT16_LIMIT;
+		xyz[axis] = (int16_t)value;
+	}
+}
+
+// function definition in header file
+int calibration_load(void)
+{
+	const calibration_t *stored = (const calibration_t *)CALIBRATION_ADDRESS;
+
+	// erased flash or a record from another layout
+	if (stored->magic != CALIBRATION_MAGIC
+			|| stored->checksum != calibration_checksum(stored))
+		return 0;
+
+	memcpy(&accel_calibration, stored, sizeof(calibration_t));
+	return 1;
+}
+
+// function definition in header file
+int calibration_run(void)
+{
+	calibration_t calibration;
+	int32_t average[AXIS_COUNT];
+	int32_t up[AXIS_COUNT], down[AXIS_COUNT];
+	int32_t span;
+	i2c_status_t status;
+
+	printf("Accelerometer calibration, keep the board still for every step\n\r");
+
+	for (int axis = 0; axis < AXIS_COUNT; axis++) {
+		// axis pointing up reads +1g
+		printf("\tPlace the board with %s pointing up and press enter\n\r",
+				axis_names[axis]);
+		while (getchar() != CARRIAGE_RETURN)
+			;
+		status = average_raw_samples(average);
+		if (status != I2C_OK) {
+			printf("\tSensor read failed (error %d), calibration aborted\n\r", status);
+			return 0;
+		}
+		up[axis] = average[axis];
+
+		// axis pointing down reads -1g
+		printf("\tPlace the board with %s pointing down and press enter\n\r",
+				axis_names[axis]);
+		while (getchar() != CARRIAGE_RETURN)
+			;
+		status = average_raw_samples(average);
+		if (status != I2C_OK) {
+			printf("\tSensor read failed (error %d), calibration aborted\n\r", status);
+			return 0;
+		}
+		down[axis] = average[axis];
+	}
+
+	calibration.magic = CALIBRATION_MAGIC;
+	for (int axis = 0; axis < AXIS_COUNT; axis++) {
+		// the readings must be about 2g apart, otherwise a step was wrong
+		span = up[axis] - down[axis];
+		if (span < COUNTS_PER_G || span > 4 * COUNTS_PER_G) {
+			printf("\t%s axis reading is invalid, calibration aborted\n\r",
+					axis_names[axis]);
+			return 0;
+		}
+
+		// offset is the midpoint, gain maps the span to exactly 2g
+		calibration.offset[axis] = (int16_t)((up[axis] + down[axis]) / 2);
+		calibration.scale[axis] = (uint16_t)(((2 * COUNTS_PER_G) << CALIBRATION_SCALE_SHIFT) / span);
+		printf("\t%s offset %d counts, gain %d/%d\n\r", axis_names[axis],
+				calibration.offset[axis], calibration.scale[axis], CALIBRATION_SCALE_ONE);
+	}
+	calibration.checksum = calibration_checksum(&calibration);
+
+	// use the new calibration even if it could not be stored
+	memcpy(&accel_calibration, &calibration, sizeof(calibration_t));
+	if (!calibration_store(&calibration)) {
+		printf("\tCalibration could not be stored in flash\n\r");
+		return 0;
+	}
+	printf("\tCalibration stored in flash\n\r");
+	return 1;
+}
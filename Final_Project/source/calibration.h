@@ -0,0 +1,73 @@
+/*****************************************************************************
+* Copyright (C) 2022 by Bhargav Dharmendra Chauhan
+*
+* Redistribution, modification or use of this software in source or binary
+* forms is permitted as long as the files maintain this copyright. Users are
+* permitted to modify this and use it to learn about the field of embedded
+* software. Bhargav Dharmendra Chauhan and the University of Colorado
+* are not liable for any misuse of this material.
+*
+*****************************************************************************/
+/*****************************************************************************
+*
+*    File name   : calibration.h
+*    Description : per axis offset and gain calibration of the MMA8451,
+*                  stored in the last flash sector
+*
+*    Author: Bhargav Dharmendra Chauhan
+*    Tools : MCUXpresso
+*    Date  : 10/19/2026
+*
+*****************************************************************************/
+
+#ifndef CALIBRATION_H_
+#define CALIBRATION_H_
+
+#include <stdint.h>
+#include "accelerometer.h"
+
+#define CALIBRATION_SCALE_SHIFT 	(14)		// gains are in Q14
+#define CALIBRATION_SCALE_ONE 		(1 << CALIBRATION_SCALE_SHIFT)
+
+// calibration record, also the layout stored in flash (word multiple)
+typedef struct
+{
+	uint32_t magic;
+	int16_t offset[AXIS_COUNT];		// zero g reading of every axis, counts
+	uint16_t scale[AXIS_COUNT];		// gain correction of every axis, Q14
+	uint32_t checksum;
+} calibration_t;
+
+// calibration applied by read_accel_xyz(), identity until loaded
+extern calibration_t accel_calibration;
+
+/*****************************************************************************
+* Applies the calibration to one sample with a multiply-shift per axis
+*
+* Parameters:
+*   xyz				raw sample, corrected in place
+*
+*****************************************************************************/
+void calibration_apply(int16_t xyz[AXIS_COUNT]);
+
+/*****************************************************************************
+* Loads the calibration stored in flash
+*
+* Returns:
+*   1 if a valid calibration was loaded, 0 if the identity is used
+*
+*****************************************************************************/
+int calibration_load(void);
+
+/*****************************************************************************
+* Runs the six orientation calibration over the uart: the user lays the
+* board with every axis pointing up and then down, the offset and gain of
+* every axis are computed and stored in flash
+*
+* Returns:
+*   1 if the calibration was computed and stored, 0 otherwise
+*
+*****************************************************************************/
+int calibration_run(void);
+
+#endif /* CALIBRATION_H_ */
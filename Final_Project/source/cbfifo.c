@@ -26,142 +26,155 @@
 
 //including the standard functions
 #include <stdint.h>
-#include "MKL25Z4.h"
+#include <string.h>
 //including the header file
 #include "cbfifo.h"
 
+// the copies must be done before the index that publishes them is written,
+// the M0+ has a single core and no cache, ordering the compiler is enough
+#define PUBLISH_BARRIER() __asm volatile ("" ::: "memory")
+
 // function description given in cbfifo.h file
-void cbfifo_init(cbfifo *cbfifo)
+int cbfifo_init(cbfifo *cbfifo, uint8_t *storage, size_t capacity)
 {
-	cbfifo->head = 0;
-	cbfifo->tail = 0;
-	cbfifo->length = 0;
-	for (unsigned int i=0; i < BUFFER_SIZE; i++)
-	    cbfifo->buffer[i] = '0';
+    //the indices are masked, a capacity of zero is not usable either
+    if(capacity == 0 || (capacity & (capacity - 1)) != 0)
+        return 0;
+
+    cbfifo->buffer = storage;
+    cbfifo->mask = capacity - 1;
+    cbfifo->head = 0;
+    cbfifo->tail = 0;
+    return 1;
 }
 
 // function description given in cbfifo.h file
 size_t cbfifo_enqueue(void *buf, size_t nbyte, cbfifo *cbfifo)
 {
-    //variable to keep track on bytes read
-    int bytesWritten = 0;
-    int bytes = nbyte;
-    uint32_t interrupt_mask;
+    uint8_t *bufferRead = (uint8_t *) buf;
+    uint32_t head = cbfifo->head;
+    uint32_t offset = head & cbfifo->mask;
+    size_t space, first;
+
+    //illegal input data
+    if((int)nbyte < 0)
+        return (size_t)-1;
 
-    // disabling the interrupt
-	interrupt_mask = __get_PRIMASK();
-	__disable_irq();
+    //the consumer may free more space meanwhile, never less
+    space = cbfifo->mask + 1 - (head - cbfifo->tail);
+    if(nbyte > space)
+        nbyte = space;
 
-    //if bytes are legal
-    if( bytes>=0 )
+    //single bytes, as from the uart interrupt, skip the memcpy calls
+    if(nbyte == 1)
     {
-        // buffer is not full then add data
-        if( cbfifo->length != BUFFER_SIZE)
-        {
-
-            //making uint8 pointer so the we can
-            //read and write single byte of data
-            //typecasting the input data to uint8
-            uint8_t *bufferRead = (uint8_t *) buf;
-
-            //loop to read required number of bytes
-            for(int i = 0; i< bytes ; i++)
-            {
-                //add data to head
-                cbfifo->buffer[cbfifo->head] = *bufferRead;
-                //move head ahead
-                //below statement is performing circular increment
-                cbfifo->head = (cbfifo->head + 1) % BUFFER_SIZE;
-                //increase different counters
-                bytesWritten++;
-                bufferRead++;
-                cbfifo->length++;
-                // if we reach tail then the buffer is full
-                if(cbfifo->head == cbfifo->tail)
-                {
-                    break;
-                }
-            }
-        }
-        // buffer is full
-        else
-        {
-            return bytesWritten;
-        }
-
+        cbfifo->buffer[offset] = *bufferRead;
     }
-    //illegal input data
+    //up to the end of the storage, then the rest from the start
     else
     {
-        return (size_t)-1;
+        first = cbfifo->mask + 1 - offset;
+        if(first > nbyte)
+            first = nbyte;
+        memcpy(&cbfifo->buffer[offset], bufferRead, first);
+        memcpy(cbfifo->buffer, bufferRead + first, nbyte - first);
     }
-    // enabling the interrupt
-    __set_PRIMASK(interrupt_mask);
-    return bytesWritten;
+
+    //make the data visible to the consumer
+    PUBLISH_BARRIER();
+    cbfifo->head = head + nbyte;
+    return nbyte;
 }
 
 // function description given in cbfifo.h file
 size_t cbfifo_dequeue(void *buf, size_t nbyte, cbfifo *cbfifo)
 {
+    uint8_t *bufferWrite = (uint8_t *) buf;
+    uint32_t tail = cbfifo->tail;
+    uint32_t offset = tail & cbfifo->mask;
+    size_t length, first;
+
     //checking illegal nbyte
     if((int)nbyte < 0)
         return -1;
 
-    //creating a uint8 pointer to point to the input data
-    uint8_t *bufferWrite = (uint8_t *) buf;
-    int bytesWritten = 0;
-    uint32_t interrupt_mask;
+    //the producer may add more data meanwhile, never less
+    length = cbfifo->head - tail;
+    if(nbyte > length)
+        nbyte = length;
 
-    //buffer empty condition
-    if(cbfifo->length == 0 )
+    //single bytes, as from the uart interrupt, skip the memcpy calls
+    if(nbyte == 1)
     {
-        return 0;
+        *bufferWrite = cbfifo->buffer[offset];
     }
-    //buffer is not empty
+    //up to the end of the storage, then the rest from the start
     else
     {
-    	// disabling the interrupt
-    	interrupt_mask = __get_PRIMASK();
-    	__disable_irq();
-        //write the required amount of bytes
-        for(int i = 0; i< nbyte ; i++)
-        {
-            //pointer to the tail data
-            *bufferWrite = cbfifo->buffer[cbfifo->tail];
-            //increment the counters
-            bufferWrite++;
-            bytesWritten++;
-            cbfifo->length--;
-            //circular increment the tail
-            cbfifo->tail = (cbfifo->tail + 1) % BUFFER_SIZE;
-            //if tail reaches the head then the buffer is empty
-            //no more data to dequeue
-            if(cbfifo->head == cbfifo->tail)
-            {
-                break;
-            }
-        }
-        // enabling the interrupt
-        __set_PRIMASK(interrupt_mask);
+        first = cbfifo->mask + 1 - offset;
+        if(first > nbyte)
+            first = nbyte;
+        memcpy(bufferWrite, &cbfifo->buffer[offset], first);
+        memcpy(bufferWrite + first, cbfifo->buffer, nbyte - first);
     }
 
-    return bytesWritten;
+    //hand the space back to the producer once the data is copied out
+    PUBLISH_BARRIER();
+    cbfifo->tail = tail + nbyte;
+    return nbyte;
 }
 
 // function description given in cbfifo.h file
 size_t cbfifo_capacity(cbfifo *cbfifo)
 {
     //returns the buffer capacity
-    return BUFFER_SIZE;
+    return cbfifo->mask + 1;
 }
 
 // function description given in cbfifo.h file
 size_t cbfifo_length(cbfifo *cbfifo)
 {
     //returns the current length of circular buffer
-    return (cbfifo->length);
+    return cbfifo->head - cbfifo->tail;
 
 }
 
+// function description given in cbfifo.h file
+size_t cbfifo_peek(cbfifo *cbfifo, uint8_t **data)
+{
+    uint32_t tail = cbfifo->tail;
+    uint32_t offset = tail & cbfifo->mask;
+    size_t length = cbfifo->head - tail;
+    size_t contiguous = cbfifo->mask + 1 - offset;
+
+    *data = &cbfifo->buffer[offset];
+    return length < contiguous ? length : contiguous;
+}
 
+// function description given in cbfifo.h file
+void cbfifo_consume(cbfifo *cbfifo, size_t nbyte)
+{
+    //the span is read before the space goes back to the producer
+    PUBLISH_BARRIER();
+    cbfifo->tail += nbyte;
+}
 
+// function description given in cbfifo.h file
+size_t cbfifo_reserve(cbfifo *cbfifo, uint8_t **data)
+{
+    uint32_t head = cbfifo->head;
+    uint32_t offset = head & cbfifo->mask;
+    size_t space = cbfifo->mask + 1 - (head - cbfifo->tail);
+    size_t contiguous = cbfifo->mask + 1 - offset;
+
+    *data = &cbfifo->buffer[offset];
+    return space < contiguous ? space : contiguous;
+}
+
+// function description given in cbfifo.h file
+void cbfifo_commit(cbfifo *cbfifo, size_t nbyte)
+{
+    //the span is written before the consumer can see it
+    PUBLISH_BARRIER();
+    cbfifo->head += nbyte;
+}
@@ -24,17 +24,21 @@
 
 //including required libraries
 #include <stdlib.h>  // for size_t
-
-//defining the buffer size statically
-#define BUFFER_SIZE (256)
+#include <stdint.h>
 
 //creating a structure to store the circular buffer parameters like head, tail etc.
+//the storage is provided by the owner of each instance, its capacity is a
+//power of two so the indices wrap with a mask instead of a division
+//single producer, single consumer: head is only written by the producer and
+//tail only by the consumer, both run freely and wrap at 2^32, their
+//difference is the length. No interrupt masking is needed when one side
+//is an interrupt handler
 typedef struct
 {
-    uint8_t buffer[BUFFER_SIZE];
-    unsigned int head;
-    unsigned int tail;
-    unsigned int length;
+    uint8_t *buffer;
+    uint32_t mask;
+    volatile uint32_t head;
+    volatile uint32_t tail;
 }cbfifo;
 
 
@@ -44,13 +48,18 @@ typedef struct
 *
 * Parameters:
 *   cbfifo *cbfifo      cbfifo instance
+*   storage				memory holding the data, owned by the caller
+*   capacity			size of storage in bytes, a power of two
+*
+* Returns:
+*   1 on success, 0 if the capacity is not a power of two
 *
 *****************************************************************************/
-void cbfifo_init(cbfifo *cbfifo);
+int cbfifo_init(cbfifo *cbfifo, uint8_t *storage, size_t capacity);
 
 /*****************************************************************************
 * Enqueues data onto the FIFO, up to the limit of the available FIFO
-* capacity.
+* capacity. Producer side, copies at most two contiguous segments.
 *
 * Parameters:
 *   buf      			Pointer to the data
@@ -67,6 +76,7 @@ size_t cbfifo_enqueue(void *buf, size_t nbyte, cbfifo *cbfifo);
 
 * Attempts to remove ("dequeue") up to nbyte bytes of data from the passed
 * FIFO. Removed data will be copied into the buffer pointed to by buf.
+* Consumer side, copies at most two contiguous segments.
 *
 * Parameters:
 *   buf      			Destination for the dequeued data
@@ -113,5 +123,60 @@ size_t cbfifo_capacity(cbfifo *cbfifo);
 *****************************************************************************/
 size_t cbfifo_length(cbfifo *cbfifo);
 
+/*****************************************************************************
+*
+* Returns the oldest data of the FIFO in place, without removing it. The
+* span ends at the end of the storage, a wrapped FIFO needs two calls
+* with a cbfifo_consume() in between. Consumer side.
+*
+* Parameters:
+*   cbfifo *cbfifo		cbfifo instance
+*   data				set to the first byte of the span
+*
+* Returns:
+*   Number of contiguous bytes readable at data, 0 if the FIFO is empty
+*
+*****************************************************************************/
+size_t cbfifo_peek(cbfifo *cbfifo, uint8_t **data);
+
+/*****************************************************************************
+*
+* Removes bytes returned by cbfifo_peek() once they are used. Consumer side.
+*
+* Parameters:
+*   cbfifo *cbfifo		cbfifo instance
+*   nbyte				bytes to remove, at most the length of the span
+*
+*****************************************************************************/
+void cbfifo_consume(cbfifo *cbfifo, size_t nbyte);
+
+/*****************************************************************************
+*
+* Returns the free space of the FIFO in place, to be filled directly and
+* then published with cbfifo_commit(). The span ends at the end of the
+* storage, like for cbfifo_peek(). Producer side.
+*
+* Parameters:
+*   cbfifo *cbfifo		cbfifo instance
+*   data				set to the first free byte
+*
+* Returns:
+*   Number of contiguous bytes writable at data, 0 if the FIFO is full
+*
+*****************************************************************************/
+size_t cbfifo_reserve(cbfifo *cbfifo, uint8_t **data);
+
+/*****************************************************************************
+*
+* Publishes bytes written in the span returned by cbfifo_reserve().
+* Producer side.
+*
+* Parameters:
+*   cbfifo *cbfifo		cbfifo instance
+*   nbyte				bytes written, at most the length of the span
+*
+*****************************************************************************/
+void cbfifo_commit(cbfifo *cbfifo, size_t nbyte);
+
 
 #endif // _CBFIFO_H_
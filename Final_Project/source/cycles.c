@@ -0,0 +1,58 @@
+/*****************************************************************************
+* Copyright (C) 2022 by Bhargav Dharmendra Chauhan
+*
+* Redistribution, modification or use of this software in source or binary
+* forms is permitted as long as the files maintain this copyright. Users are
+* permitted to modify this and use it to learn about the field of embedded
+* software. Bhargav Dharmendra Chauhan and the University of Colorado
+* are not liable for any misuse of this material.
+*
+*****************************************************************************/
+/*****************************************************************************
+*
+*    File name   : cycles.c
+*    Description : core clock cycle counter built on the SysTick timer
+*
+*    Author: Bhargav Dharmendra Chauhan
+*    Tools : MCUXpresso
+*    Date  : 10/19/2026
+*
+*****************************************************************************/
+
+// including required libraries
+#include "MKL25Z4.h"
+#include "fsl_clock.h"
+#include "cycles.h"
+
+#define HZ_PER_MHZ 		(1000000U)
+
+// set by cycles_init()
+uint32_t cycles_per_us = 1;
+
+// function definition in header file
+void cycles_init(void)
+{
+	// sysclock_init() leaves SIM_CLKDIV1 as the boot clock set it
+	cycles_per_us = CLOCK_GetCoreSysClkFreq() / HZ_PER_MHZ;
+
+	// full 24 bit reload so the counter wraps as late as possible
+	SysTick->CTRL = 0;
+	SysTick->LOAD = CYCLES_MAX_INTERVAL;
+	SysTick->VAL = 0;
+
+	// core clock source, counter enabled, no interrupt
+	SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+}
+
+// function definition in header file
+uint32_t cycles_now(void)
+{
+	return SysTick->VAL;
+}
+
+// function definition in header file
+uint32_t cycles_since(uint32_t start)
+{
+	// down counter, the mask handles a single wrap around
+	return (start - SysTick->VAL) & CYCLES_MAX_INTERVAL;
+}
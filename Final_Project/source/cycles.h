@@ -0,0 +1,58 @@
+/*****************************************************************************
+* Copyright (C) 2022 by Bhargav Dharmendra Chauhan
+*
+* Redistribution, modification or use of this software in source or binary
+* forms is permitted as long as the files maintain this copyright. Users are
+* permitted to modify this and use it to learn about the field of embedded
+* software. Bhargav Dharmendra Chauhan and the University of Colorado
+* are not liable for any misuse of this material.
+*
+*****************************************************************************/
+/*****************************************************************************
+*
+*    File name   : cycles.h
+*    Description : core clock cycle counter built on the SysTick timer,
+*                  used for benchmarks and short timeouts
+*
+*    Author: Bhargav Dharmendra Chauhan
+*    Tools : MCUXpresso
+*    Date  : 10/19/2026
+*
+*****************************************************************************/
+
+#ifndef CYCLES_H_
+#define CYCLES_H_
+
+#include <stdint.h>
+
+// SysTick is a 24 bit counter, intervals must stay below ~1.4 s at 12 MHz
+#define CYCLES_MAX_INTERVAL 	(0x00FFFFFFU)
+#define CYCLES_PER_US 			(cycles_per_us)
+
+// core clock cycles per microsecond, read from the clock configuration by
+// cycles_init(), the core runs at the FLL output divided by OUTDIV1
+extern uint32_t cycles_per_us;
+
+/*****************************************************************************
+* Starts SysTick as a free running down counter on the core clock, without
+* interrupts, and reads the core clock frequency for CYCLES_PER_US
+*
+*****************************************************************************/
+void cycles_init(void);
+
+/*****************************************************************************
+* Returns the current counter value, to be passed to cycles_since()
+*
+*****************************************************************************/
+uint32_t cycles_now(void);
+
+/*****************************************************************************
+* Returns the number of core clock cycles elapsed since a cycles_now() value
+*
+* Parameters:
+*   start			value returned by cycles_now()
+*
+*****************************************************************************/
+uint32_t cycles_since(uint32_t start);
+
+#endif /* CYCLES_H_ */
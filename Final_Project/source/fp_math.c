@@ -0,0 +1,134 @@
+/*****************************************************************************
+* Copyright (C) 2022 by Bhargav Dharmendra Chauhan
+*
+* Redistribution, modification or use of this software in source or binary
+* forms is permitted as long as the files maintain this copyright. Users are
+* permitted to modify this and use it to learn about the field of embedded
+* software. Bhargav Dharmendra Chauhan and the University of Colorado
+* are not liable for any misuse of this material.
+*
+*****************************************************************************/
+/*****************************************************************************
+*
+*    File name   : fp_math.c
+*    Description : integer only math helpers used by the angle pipeline
+*
+*    Author: Bhargav Dharmendra Chauhan
+*    Tools : MCUXpresso
+*    Date  : 10/19/2026
+*
+*****************************************************************************/
+
+// including required libraries
+#include <stdint.h>
+#include "fp_math.h"
+
+#define ATAN_TABLE_STEPS 		(32)
+#define ATAN_RATIO_SHIFT 		(16)		// ratio is in Q16 format
+#define ATAN_STEP_SHIFT 		(11)		// Q16 / 32 steps
+#define ATAN_STEP_MASK 			((1 << ATAN_STEP_SHIFT) - 1)
+#define ATAN_MAX_INPUT 			(0xFFFF)	// keeps (input << 16) inside 32 bits
+#define ISQRT_FIRST_BIT 		(1UL << 30)	// highest power of four in 32 bits
+#define ISQRT64_FIRST_BIT 		(1ULL << 62)	// highest power of four in 64 bits
+
+// atan(i/32) lookup table in centi-degrees
+static const int16_t atan_lookup[ATAN_TABLE_STEPS + 1] = { 0, 179, 358, 536,
+		713, 888, 1062, 1234, 1404, 1571, 1735, 1897, 2056, 2211, 2363, 2511,
+		2657, 2798, 2936, 3070, 3201, 3327, 3451, 3571, 3687, 3800, 3909, 4016,
+		4119, 4218, 4315, 4409, 4500 };
+
+// arc tangent of a Q16 ratio between 0 and 1, result in centi-degrees
+static int32_t atan_ratio(uint32_t ratio)
+{
+	uint32_t index = ratio >> ATAN_STEP_SHIFT;
+	int32_t frac = ratio & ATAN_STEP_MASK;
+	int32_t y1, y2;
+
+	// ratio of exactly one is the last table entry
+	if (index >= ATAN_TABLE_STEPS)
+		return atan_lookup[ATAN_TABLE_STEPS];
+
+	// linear interpolation between two table entries, rounded
+	y1 = atan_lookup[index];
+	y2 = atan_lookup[index + 1];
+	return y1 + (((y2 - y1) * frac + (1 << (ATAN_STEP_SHIFT - 1))) >> ATAN_STEP_SHIFT);
+}
+
+// definition of the function in the header file
+int32_t fp_atan2(int32_t y, int32_t x)
+{
+	uint32_t abs_x = (x < 0) ? -x : x;
+	uint32_t abs_y = (y < 0) ? -y : y;
+	int32_t angle;
+
+	// angle of a null vector is taken as 0
+	if (abs_x == 0 && abs_y == 0)
+		return 0;
+
+	// scale both components down so the ratio fits in 32 bits
+	while (abs_x > ATAN_MAX_INPUT || abs_y > ATAN_MAX_INPUT) {
+		abs_x >>= 1;
+		abs_y >>= 1;
+	}
+
+	// reduce to the first octant, ratio is always between 0 and 1
+	if (abs_y <= abs_x)
+		angle = atan_ratio((abs_y << ATAN_RATIO_SHIFT) / abs_x);
+	else
+		angle = CDEG_90 - atan_ratio((abs_x << ATAN_RATIO_SHIFT) / abs_y);
+
+	// unfold to the correct quadrant
+	if (x < 0)
+		angle = CDEG_180 - angle;
+	if (y < 0)
+		angle = -angle;
+
+	return angle;
+}
+
+// definition of the function in the header file
+uint32_t fp_isqrt(uint32_t value)
+{
+	uint32_t root = 0;
+	uint32_t bit = ISQRT_FIRST_BIT;
+
+	// start from the highest power of four not above the value
+	while (bit > value)
+		bit >>= 2;
+
+	// build the root one bit at a time
+	while (bit != 0) {
+		if (value >= root + bit) {
+			value -= root + bit;
+			root = (root >> 1) + bit;
+		} else {
+			root >>= 1;
+		}
+		bit >>= 2;
+	}
+
+	return root;
+}
+
+// definition of the function in the header file
+uint32_t fp_isqrt64(uint64_t value)
+{
+	uint64_t root = 0;
+	uint64_t bit = ISQRT64_FIRST_BIT;
+
+	// same method as fp_isqrt on 64 bit operands
+	while (bit > value)
+		bit >>= 2;
+
+	while (bit != 0) {
+		if (value >= root + bit) {
+			value -= root + bit;
+			root = (root >> 1) + bit;
+		} else {
+			root >>= 1;
+		}
+		bit >>= 2;
+	}
+
+	return (uint32_t)root;
+}
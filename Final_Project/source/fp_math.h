@@ -0,0 +1,69 @@
+/*****************************************************************************
+* Copyright (C) 2022 by Bhargav Dharmendra Chauhan
+*
+* Redistribution, modification or use of this software in source or binary
+* forms is permitted as long as the files maintain this copyright. Users are
+* permitted to modify this and use it to learn about the field of embedded
+* software. Bhargav Dharmendra Chauhan and the University of Colorado
+* are not liable for any misuse of this material.
+*
+*****************************************************************************/
+/*****************************************************************************
+*
+*    File name   : fp_math.h
+*    Description : integer only math helpers used by the angle pipeline
+*
+*    Author: Bhargav Dharmendra Chauhan
+*    Tools : MCUXpresso
+*    Date  : 10/19/2026
+*
+*****************************************************************************/
+
+#ifndef FP_MATH_H_
+#define FP_MATH_H_
+
+#include <stdint.h>
+
+// angles are expressed in centi-degrees (1/100 degree)
+#define CDEG_PER_DEGREE 	(100)
+#define CDEG_90 			(9000)
+#define CDEG_180 			(18000)
+
+/*****************************************************************************
+* Integer four quadrant arc tangent, replaces atan2() from math.h
+* Uses an interpolated lookup table, one division per call
+*
+* Parameters:
+*   y, x			vector components, any magnitude
+*
+* Returns:
+*   angle of the vector in centi-degrees, range -18000 to 18000
+*
+*****************************************************************************/
+int32_t fp_atan2(int32_t y, int32_t x);
+
+/*****************************************************************************
+* Integer square root using the bitwise shift/subtract method, no division
+*
+* Parameters:
+*   value			number whose square root is to be calculated
+*
+* Returns:
+*   floor of the square root of value
+*
+*****************************************************************************/
+uint32_t fp_isqrt(uint32_t value);
+
+/*****************************************************************************
+* 64 bit version of fp_isqrt, slower, meant for configuration time math
+*
+* Parameters:
+*   value			number whose square root is to be calculated
+*
+* Returns:
+*   floor of the square root of value
+*
+*****************************************************************************/
+uint32_t fp_isqrt64(uint64_t value);
+
+#endif /* FP_MATH_H_ */
@@ -28,13 +28,17 @@
 
 #include "accelerometer.h"
 #include "gpio_interrupt.h"
+#include "motion.h"
 
 // defining macros
 #define DEBOUNCE_TIME (10000)
 #define RISING_EDGE_INTERRUPT (9)
+#define SWITCH_PIN (13)
+#define MOTION_PIN (14)
 
 // initalizing global variables
-int reference_angle = 0, reference_angle_flag = 0;
+volatile angle_t reference_angle = 0;
+volatile int reference_angle_flag = 0;
 
 // function declaration in header file
 void init_gpio_interrupt()
@@ -43,7 +47,7 @@ void init_gpio_interrupt()
 	SIM->SCGC5 |= SIM_SCGC5_PORTA_MASK;
 
 	// initialize the pin control register for tactile switch gpio
-	PORTA->PCR[13] = PORT_PCR_MUX(1)						|		// setting type as gpio
+	PORTA->PCR[SWITCH_PIN] = PORT_PCR_MUX(1)						|		// setting type as gpio
 					PORT_PCR_IRQC(RISING_EDGE_INTERRUPT)	;		// interrupt on rising edge
 
 	// Clear current interrupt and enable interrupt
@@ -54,18 +58,37 @@ void init_gpio_interrupt()
 	printf("GPIO Interrupt Enabled\n\r");
 }
 
+// enables or disables the switch interrupt, port A stays enabled for the
+// other pins
+static void switch_interrupt(int enable)
+{
+	PORTA->PCR[SWITCH_PIN] = (PORTA->PCR[SWITCH_PIN] & ~(PORT_PCR_IRQC_MASK | PORT_PCR_ISF_MASK))
+			| PORT_PCR_IRQC(enable ? RISING_EDGE_INTERRUPT : 0);
+}
+
 // function declaration in header file
 void PORTA_IRQHandler()
 {
-	// clear the interrupt status flag and disable interrupt
-	PORTA->PCR[13] |= PORT_PCR_ISF(1);
-	NVIC_DisableIRQ(PORTA_IRQn);
+	uint32_t flags = PORTA->ISFR;
+	sample_t sample;
 
-	// read the start angle from user angle
-	reference_angle = read_roll_angle();
+	// clear the flags that were read, each pin is handled below
+	PORTA->ISFR = flags;
 
-	// set reference angle flag
-	reference_angle_flag = 1;
+	// accelerometer INT1, movement detected
+	if (flags & (1UL << MOTION_PIN))
+		motion_interrupt();
+
+	if (!(flags & (1UL << SWITCH_PIN)))
+		return;
+
+	// the reference is the latest sample of the main loop, the bus is
+	// never used from here. The switch is disabled once it is set
+	if (latest_sample(&sample)) {
+		reference_angle = sample.tilt.roll;
+		reference_angle_flag = 1;
+		switch_interrupt(0);
+	}
 
 	// software de-bouncing for input switch
 	for(int i = 0; i < DEBOUNCE_TIME; i++)
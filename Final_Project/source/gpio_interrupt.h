@@ -22,8 +22,11 @@
 #ifndef GPIO_INTERRUPT_H_
 #define GPIO_INTERRUPT_H_
 
+#include "accelerometer.h"
+
 // declaring global extern variables
-extern int reference_angle, reference_angle_flag;
+extern volatile angle_t reference_angle;
+extern volatile int reference_angle_flag;
 
 //function definitions
 
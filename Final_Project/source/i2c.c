@@ -22,11 +22,50 @@
 
 // including require libraries
 #include "MKL25Z4.h"
+#include "fsl_clock.h"
 #include "i2c.h"
-
-// declaring global variables
-int lock_detect = 0;
-int lock_i2c = 0;
+#include "cycles.h"
+#ifdef I2C_INSTRUMENTATION
+#include <stdio.h>
+#include <string.h>
+#include "timebase.h"
+#endif
+
+#define ICR_COUNT 	(64)		// number of ICR settings
+#define MULT_COUNT 	(3)			// MULT selects a factor of 1, 2 or 4
+
+// i2c pins on port E, and their alternatives for the bus recovery
+#define SCL_PIN 		(24)
+#define SDA_PIN 		(25)
+#define I2C_PIN_MUX 	(5)
+#define GPIO_PIN_MUX 	(1)
+#define MASK(x) 		(1UL << (x))
+
+#define BITS_PER_BYTE 		(9)			// 8 data bits and the acknowledge
+#define US_PER_SECOND 		(1000000U)
+#define RECOVERY_CLOCKS 	(9)			// enough for a slave to finish a byte
+#define RECOVERY_HALF_US 	(5)			// 100 kHz recovery clock
+
+// error and recovery counters
+volatile i2c_error_counters_t i2c_error_counters;
+
+#ifdef I2C_INSTRUMENTATION
+// transaction statistics and the time they started to be collected
+volatile i2c_stats_t i2c_stats;
+static uint64_t stats_start_us = 0;
+#endif
+
+// SCL divider of every ICR value, KL25 reference manual I2C divider table
+static const uint16_t scl_divider[ICR_COUNT] = {
+	20, 22, 24, 26, 28, 30, 34, 40, 28, 32, 36, 40, 44, 48, 56, 68,
+	48, 56, 64, 72, 80, 88, 104, 128, 80, 96, 112, 128, 144, 160, 192, 240,
+	160, 192, 224, 256, 288, 320, 384, 480, 320, 384, 448, 512, 576, 640, 768, 960,
+	640, 768, 896, 1024, 1152, 1280, 1536, 1920, 1280, 1536, 1792, 2048, 2304, 2560, 3072, 3840
+};
+
+// SCL frequency currently programmed and the matching byte timeout
+static uint32_t scl_frequency = 0;
+static uint32_t timeout_cycles = 0;
 
 // function definition in header file
 void i2c_init(void)
@@ -36,223 +75,386 @@ void i2c_init(void)
 	SIM->SCGC5 |= (SIM_SCGC5_PORTE_MASK);
 
 	// set I2C pins
-	PORTE->PCR[24] |= PORT_PCR_MUX(5);
-	PORTE->PCR[25] |= PORT_PCR_MUX(5);
+	PORTE->PCR[SCL_PIN] = PORT_PCR_MUX(I2C_PIN_MUX);
+	PORTE->PCR[SDA_PIN] = PORT_PCR_MUX(I2C_PIN_MUX);
 
-	// baud set to 100k
-	// baud = bus freq/(scl_div+mul)
- 	//~400k = 24M/(64); icr=0x12 sets scl_div to 64
+	// timeouts are measured in core clock cycles
+	cycles_init();
 
- 	I2C0->F = (I2C_F_ICR(0x10) | I2C_F_MULT(0));
+	// baud = bus freq / (mul * scl_div), fast mode for the accelerometer
+	i2c_set_speed(I2C_SPEED_FAST);
 
 	//enable i2c and set to master mode
 	I2C0->C1 |= (I2C_C1_IICEN_MASK);
 
 	// Select high drive mode
 	I2C0->C2 |= (I2C_C2_HDRS_MASK);
+
+#ifdef I2C_INSTRUMENTATION
+	i2c_stats_reset();
+#endif
 }
 
 // function definition in header file
-void i2c_busy(void){
+uint8_t i2c_compute_divider(uint32_t target_hz, uint32_t *achieved_hz)
+{
+	uint32_t bus_clock = CLOCK_GetBusClkFreq();
+	uint32_t best_divider = 0, divider;
+	uint8_t best_icr = ICR_COUNT - 1, best_mult = MULT_COUNT - 1;
+
+	// smallest total divider that keeps SCL at or below the target
+	for (uint8_t mult = 0; mult < MULT_COUNT; mult++) {
+		for (uint8_t icr = 0; icr < ICR_COUNT; icr++) {
+			divider = (uint32_t)scl_divider[icr] << mult;
+			if ((uint64_t)target_hz * divider >= bus_clock
+					&& (best_divider == 0 || divider < best_divider)) {
+				best_divider = divider;
+				best_icr = icr;
+				best_mult = mult;
+			}
+		}
+	}
 
+	// slowest setting when even that is above the target
+	if (best_divider == 0)
+		best_divider = (uint32_t)scl_divider[best_icr] << best_mult;
 
-	// Start Signal
-	lock_detect=0;
-	I2C0->C1 &= ~I2C_C1_IICEN_MASK;
-	I2C_TRAN;
-	I2C_M_START;
-	I2C0->C1 |=  I2C_C1_IICEN_MASK;
+	*achieved_hz = bus_clock / best_divider;
+	return I2C_F_ICR(best_icr) | I2C_F_MULT(best_mult);
+}
 
-	// Write to clear line
-	I2C0->C1 |= I2C_C1_MST_MASK;  	//set MASTER mode
-	I2C0->C1 |= I2C_C1_TX_MASK; 	// Set transmit (TX) mode
-	I2C0->D = 0xFF;
+// function definition in header file
+void i2c_apply_divider(uint8_t divider, uint32_t achieved_hz)
+{
+	// nothing to do when the bus already runs at this rate
+	if (I2C0->F == divider && scl_frequency == achieved_hz)
+		return;
 
-	// wait for interrupt
-	while ((I2C0->S & I2C_S_IICIF_MASK) == 0U) {
-	}
-	// clear interrupt bit
-	I2C0->S |= I2C_S_IICIF_MASK;
+	I2C0->F = divider;
+	scl_frequency = achieved_hz;
 
+	// a byte may take I2C_TIMEOUT_BYTES byte times before it is a timeout
+	timeout_cycles = (BITS_PER_BYTE * I2C_TIMEOUT_BYTES * US_PER_SECOND / scl_frequency + 1)
+			* CYCLES_PER_US;
+}
 
-	// Clear arbitration error flag
-	I2C0->S |= I2C_S_ARBL_MASK;
+// function definition in header file
+uint32_t i2c_set_speed(uint32_t target_hz)
+{
+	uint32_t achieved_hz;
+	uint8_t divider = i2c_compute_divider(target_hz, &achieved_hz);
 
+	i2c_apply_divider(divider, achieved_hz);
+	return achieved_hz;
+}
 
-	// Send start,  Set transmit (TX) mode, START signal generated
-	I2C0->C1 &= ~I2C_C1_IICEN_MASK;
-	I2C0->C1 |= I2C_C1_TX_MASK;
-	I2C0->C1 |= I2C_C1_MST_MASK;
+// function definition in header file
+uint32_t i2c_get_speed(void)
+{
+	return scl_frequency;
+}
 
-	// Wait until start is send
-	I2C0->C1 |= I2C_C1_IICEN_MASK;
+// busy waits for a number of microseconds
+static void delay_us(uint32_t us)
+{
+	uint32_t start = cycles_now();
 
+	while (cycles_since(start) < us * CYCLES_PER_US)
+		;
+}
 
-	// send stop, set slave mode
-	I2C0->C1 &= ~I2C_C1_IICEN_MASK;
-	I2C0->C1 |= I2C_C1_MST_MASK;
+// function definition in header file
+i2c_status_t i2c_recover_bus(void)
+{
+	i2c_status_t status = I2C_OK;
+
+	i2c_error_counters.recoveries++;
+
+	// take the pins away from the i2c module, pulled up like the bus
+	I2C0->C1 = 0;
+	PORTE->PCR[SCL_PIN] = PORT_PCR_MUX(GPIO_PIN_MUX) | PORT_PCR_PE_MASK | PORT_PCR_PS_MASK;
+	PORTE->PCR[SDA_PIN] = PORT_PCR_MUX(GPIO_PIN_MUX) | PORT_PCR_PE_MASK | PORT_PCR_PS_MASK;
+	GPIOE->PSOR = MASK(SCL_PIN);
+	GPIOE->PDDR |= MASK(SCL_PIN);
+	GPIOE->PDDR &= ~MASK(SDA_PIN);
+
+	// clock SCL until the slave releases SDA
+	for (int i = 0; i < RECOVERY_CLOCKS && !(GPIOE->PDIR & MASK(SDA_PIN)); i++) {
+		GPIOE->PCOR = MASK(SCL_PIN);
+		delay_us(RECOVERY_HALF_US);
+		GPIOE->PSOR = MASK(SCL_PIN);
+		delay_us(RECOVERY_HALF_US);
+	}
 
-	// set receiver
-	I2C0->C1 &= ~I2C_C1_MST_MASK;
-	I2C0->C1 &= ~I2C_C1_TX_MASK;
+	// STOP condition: SDA rises while SCL is high
+	GPIOE->PCOR = MASK(SCL_PIN);
+	GPIOE->PCOR = MASK(SDA_PIN);
+	GPIOE->PDDR |= MASK(SDA_PIN);
+	delay_us(RECOVERY_HALF_US);
+	GPIOE->PSOR = MASK(SCL_PIN);
+	delay_us(RECOVERY_HALF_US);
+	GPIOE->PDDR &= ~MASK(SDA_PIN);
+	delay_us(RECOVERY_HALF_US);
+
+	if (!(GPIOE->PDIR & MASK(SDA_PIN))) {
+		i2c_error_counters.recovery_failures++;
+		status = I2C_ERR_BUS_STUCK;
+	}
 
-	// wait
-	I2C0->C1 |= I2C_C1_IICEN_MASK;
+	// give the pins back to the i2c module and restart it
+	GPIOE->PDDR &= ~(MASK(SCL_PIN) | MASK(SDA_PIN));
+	PORTE->PCR[SCL_PIN] = PORT_PCR_MUX(I2C_PIN_MUX);
+	PORTE->PCR[SDA_PIN] = PORT_PCR_MUX(I2C_PIN_MUX);
+	I2C0->S = I2C_S_IICIF_MASK | I2C_S_ARBL_MASK;
+	I2C0->C1 = I2C_C1_IICEN_MASK;
 
-	// Clear arbitration error & interrupt flag
-	I2C0->S |= I2C_S_IICIF_MASK;
-	I2C0->S |= I2C_S_ARBL_MASK;
-	lock_detect=0;
-	lock_i2c=1;
+	return status;
 }
 
-// function definition in header file
-void i2c_wait(void) {
+// waits for the end of the current byte, bounded by the byte timeout
+static i2c_status_t i2c_wait(void)
+{
+	uint32_t start = cycles_now();
 
-	lock_detect = 0;
+	while ((I2C0->S & I2C_S_IICIF_MASK) == 0) {
+		if (cycles_since(start) > timeout_cycles) {
+			i2c_error_counters.timeouts++;
+			return I2C_ERR_TIMEOUT;
+		}
+	}
+	// flags are write 1 to clear, clear only the interrupt flag
+	I2C0->S = I2C_S_IICIF_MASK;
 
-	while(((I2C0->S & I2C_S_IICIF_MASK)==0) & (lock_detect < 200)) {
-		lock_detect++;
+	if (I2C0->S & I2C_S_ARBL_MASK) {
+		I2C0->S = I2C_S_ARBL_MASK;
+		i2c_error_counters.arbitration_lost++;
+		return I2C_ERR_ARBITRATION;
 	}
+	return I2C_OK;
+}
 
-	if (lock_detect >= 200)
-		i2c_busy();
+// sends one byte and checks that the slave acknowledged it
+static i2c_status_t i2c_send(uint8_t data)
+{
+	i2c_status_t status;
 
-	I2C0->S |= I2C_S_IICIF_MASK;
+	I2C0->D = data;
+	status = i2c_wait();
+	if (status == I2C_OK && (I2C0->S & I2C_S_RXAK_MASK)) {
+		i2c_error_counters.nacks++;
+		status = I2C_ERR_NACK;
+	}
+	return status;
 }
 
-// function definition in header file
-void i2c_start()
+// sends start and the device address in write mode
+static i2c_status_t i2c_start(uint8_t dev)
 {
-	// set to transmit mode
+	// a slave still holding SDA from an aborted transfer
+	if (I2C0->S & I2C_S_BUSY_MASK) {
+		if (i2c_recover_bus() != I2C_OK)
+			return I2C_ERR_BUS_STUCK;
+	}
+
+	//set to transmit mode
 	I2C_TRAN;
-	// send start signal
+	//send start
 	I2C_M_START;
+	//send dev address
+	return i2c_send(dev);
 }
 
-// function definition in header file
-void i2c_read_setup(uint8_t dev, uint8_t address)
+// ends a failed transfer, recovering the bus if the slave still holds it,
+// a bus that cannot be recovered is reported instead of the first error
+static i2c_status_t i2c_abort(i2c_status_t status)
 {
-	//send dev address
-	I2C0->D = dev;
-	//wait for completion
-	I2C_WAIT
-
-	//send read address
-	I2C0->D =  address;
-	//wait for completion
-	I2C_WAIT
-
-	//repeated start
-	I2C_M_RSTART;
-	//send dev address (read)
-	I2C0->D = (dev|0x1);
-	//wait for completion
-	I2C_WAIT
-	//set to receive mode
+	I2C_M_STOP;
 	I2C_REC;
 
+	if ((status == I2C_ERR_TIMEOUT || status == I2C_ERR_ARBITRATION)
+			&& i2c_recover_bus() != I2C_OK)
+		return I2C_ERR_BUS_STUCK;
+	return status;
 }
 
-// function definition in header file
-uint8_t i2c_repeated_read(uint8_t isLastRead)
+// reads consecutive registers, see i2c_read_burst()
+static i2c_status_t read_burst(uint8_t dev, uint8_t address, uint8_t *data, uint8_t length)
 {
-	// initialize variable
-	uint8_t data;
-	lock_detect = 0;
+	i2c_status_t status;
+	uint8_t i;
+
+	//send dev address, then the register address
+	status = i2c_start(dev);
+	if (status == I2C_OK)
+		status = i2c_send(address);
+
+	//repeated start and dev address (read)
+	if (status == I2C_OK) {
+		I2C_M_RSTART;
+		status = i2c_send(dev | 0x1);
+	}
+	if (status != I2C_OK)
+		return i2c_abort(status);
 
-	// set NACK after read
-	if(isLastRead)
-	{
+	//set to receive mode, a single byte is not acknowledged
+	I2C_REC;
+	if (length == 1)
 		NACK;
-	}
-	// ACK after read
 	else
-	{
 		ACK;
-	}
-	// dummy read
-	data = I2C0->D;
-	// wait for completion
-	I2C_WAIT;
 
-	// send stop
-	if(isLastRead)	{
-		I2C_M_STOP;
-	}
-	// read data
-	data = I2C0->D;
+	//dummy read starts the first byte
+	data[0] = I2C0->D;
 
-	// return data
-	return  data;
-}
+	for (i = 0; i < length; i++) {
+		status = i2c_wait();
+		if (status != I2C_OK)
+			return i2c_abort(status);
 
+		//the byte after the next one is the last one: NACK it
+		if (i == length - 2)
+			NACK;
 
-// function definition in header file
-uint8_t i2c_read_byte(uint8_t dev, uint8_t address)
+		//send stop before reading the last byte so no new byte starts
+		if (i == length - 1)
+			I2C_M_STOP;
+
+		//read data, this starts the next byte
+		data[i] = I2C0->D;
+	}
+	return I2C_OK;
+}
+
+// writes consecutive registers, see i2c_write_burst()
+static i2c_status_t write_burst(uint8_t dev, uint8_t address, const uint8_t *data,
+		uint8_t length)
 {
-	uint8_t data;
+	i2c_status_t status;
 
-	//set to transmit mode
-	I2C_TRAN;
-	//send start
-	I2C_M_START;
-	//send dev address
-	I2C0->D = dev;
-	//wait for completion
-	I2C_WAIT
-	//send read address
-	I2C0->D =  address;
-	// wait for completion
-	I2C_WAIT
-	//repeated start
-	I2C_M_RSTART;
-	//send dev address (read)
-	I2C0->D = (dev|0x1);
-	//wait for completion
-	I2C_WAIT
-
-	//set to receive mode
-	I2C_REC;
-	//set NACK after read
-	NACK;
+	//send dev address and write address
+	status = i2c_start(dev);
+	if (status == I2C_OK)
+		status = i2c_send(address);
+
+	//send data, the slave increments the register address
+	for (uint8_t i = 0; i < length && status == I2C_OK; i++)
+		status = i2c_send(data[i]);
 
-	//dummy read
-	data = I2C0->D;
-	//wait for completion
-	I2C_WAIT
+	if (status != I2C_OK)
+		return i2c_abort(status);
 
-	//send stop
+	// send stop
 	I2C_M_STOP;
-	//read data
-	data = I2C0->D;
-	//return data
-	return data;
+	return I2C_OK;
 }
 
+#ifdef I2C_INSTRUMENTATION
+// adds one transaction to the statistics
+static void stats_record(uint32_t start, i2c_status_t status, uint8_t length, int write)
+{
+	uint32_t us = cycles_since(start) / CYCLES_PER_US;
+	uint32_t bin = 0;
+
+	// log2 without a count leading zeros instruction on the M0+
+	while (bin < I2C_HISTOGRAM_BINS - 1 && (us >> (bin + 1)) != 0)
+		bin++;
+
+	if (write) {
+		i2c_stats.writes++;
+		i2c_stats.bytes_written += length;
+	} else {
+		i2c_stats.reads++;
+		i2c_stats.bytes_read += length;
+	}
+	if (status != I2C_OK)
+		i2c_stats.failures++;
+	i2c_stats.busy_us += us;
+	if (us > i2c_stats.max_us)
+		i2c_stats.max_us = us;
+	i2c_stats.histogram[bin]++;
+}
+#endif
+
 // function definition in header file
-void i2c_write_byte(uint8_t dev, uint8_t address, uint8_t data)
+i2c_status_t i2c_read_burst(uint8_t dev, uint8_t address, uint8_t *data, uint8_t length)
 {
+#ifdef I2C_INSTRUMENTATION
+	uint32_t start = cycles_now();
+	i2c_status_t status = read_burst(dev, address, data, length);
+
+	stats_record(start, status, length, 0);
+	return status;
+#else
+	return read_burst(dev, address, data, length);
+#endif
+}
 
-	//set to transmit mode
-	I2C_TRAN;
-	//send start
-	I2C_M_START;
-	//send dev address
-	I2C0->D = dev;
-	//wait for ack
-	I2C_WAIT
+// function definition in header file
+i2c_status_t i2c_read_byte(uint8_t dev, uint8_t address, uint8_t *data)
+{
+	return i2c_read_burst(dev, address, data, 1);
+}
 
-	//send write address
-	I2C0->D =  address;
-	//wait for completion
-	I2C_WAIT
+// function definition in header file
+i2c_status_t i2c_write_burst(uint8_t dev, uint8_t address, const uint8_t *data, uint8_t length)
+{
+#ifdef I2C_INSTRUMENTATION
+	uint32_t start = cycles_now();
+	i2c_status_t status = write_burst(dev, address, data, length);
+
+	stats_record(start, status, length, 1);
+	return status;
+#else
+	return write_burst(dev, address, data, length);
+#endif
+}
 
-	//send data
-	I2C0->D = data;
-	//wait for completion
-	I2C_WAIT
-	// send stop
-	I2C_M_STOP;
+// function definition in header file
+i2c_status_t i2c_write_byte(uint8_t dev, uint8_t address, uint8_t data)
+{
+	return i2c_write_burst(dev, address, &data, 1);
+}
 
+#ifdef I2C_INSTRUMENTATION
+// function definition in header file
+void i2c_stats_reset(void)
+{
+	memset((void *)&i2c_stats, 0, sizeof(i2c_stats));
+	memset((void *)&i2c_error_counters, 0, sizeof(i2c_error_counters));
+	stats_start_us = timebase_now_us();
+}
+
+// function definition in header file
+void i2c_stats_dump(void)
+{
+	i2c_stats_t stats = i2c_stats;
+	uint32_t elapsed_ms = (uint32_t)((timebase_now_us() - stats_start_us) / 1000);
+	uint32_t transactions = stats.reads + stats.writes;
+	uint32_t low;
+
+	printf("I2C statistics over %d ms, SCL %d Hz:\n\r", (int)elapsed_ms, (int)scl_frequency);
+	printf("\t%d reads (%d bytes), %d writes (%d bytes), %d failed\n\r",
+			(int)stats.reads, (int)stats.bytes_read, (int)stats.writes,
+			(int)stats.bytes_written, (int)stats.failures);
+	printf("\t%d nacks, %d timeouts, %d arbitration lost, %d recoveries (%d failed)\n\r",
+			(int)i2c_error_counters.nacks, (int)i2c_error_counters.timeouts,
+			(int)i2c_error_counters.arbitration_lost, (int)i2c_error_counters.recoveries,
+			(int)i2c_error_counters.recovery_failures);
+	// share of the elapsed time, busy_us * 100 / (elapsed_ms * 1000)
+	printf("\tbusy %d ms (%d%%), mean %d us, max %d us\n\r", (int)(stats.busy_us / 1000),
+			elapsed_ms ? (int)(stats.busy_us / 10 / elapsed_ms) : 0,
+			transactions ? (int)(stats.busy_us / transactions) : 0, (int)stats.max_us);
+
+	// one line per non empty bin
+	for (int bin = 0; bin < I2C_HISTOGRAM_BINS; bin++) {
+		if (stats.histogram[bin] == 0)
+			continue;
+		low = bin ? (1UL << bin) : 0;
+		if (bin == I2C_HISTOGRAM_BINS - 1)
+			printf("\t%5d us and more: %d\n\r", (int)low, (int)stats.histogram[bin]);
+		else
+			printf("\t%5d to %5d us: %d\n\r", (int)low, (int)((2UL << bin) - 1),
+					(int)stats.histogram[bin]);
+	}
 }
+#endif
@@ -34,13 +34,75 @@
 #define I2C_TRAN			I2C0->C1 |= I2C_C1_TX_MASK
 #define I2C_REC				I2C0->C1 &= ~I2C_C1_TX_MASK
 
-#define BUSY_ACK 	    	while(I2C0->S & 0x01)
-#define TRANS_COMP			while(!(I2C0->S & 0x80))
-#define I2C_WAIT 			i2c_wait();
-
 #define NACK 	        	I2C0->C1 |= I2C_C1_TXAK_MASK
 #define ACK           		I2C0->C1 &= ~I2C_C1_TXAK_MASK
 
+// SCL rates accepted by i2c_set_speed()
+#define I2C_SPEED_STANDARD	(100000U)		// standard mode
+#define I2C_SPEED_FAST		(400000U)		// fast mode, MMA8451 rated maximum
+#define I2C_SPEED_MAX		(1000000U)		// fast mode plus, fastest the bus is run at
+
+// a byte that takes longer than this many byte times is a timeout
+#define I2C_TIMEOUT_BYTES	(4)
+
+// result of every i2c operation
+typedef enum
+{
+	I2C_OK = 0,					// transfer completed
+	I2C_ERR_TIMEOUT,			// byte not completed within the timeout
+	I2C_ERR_NACK,				// slave did not acknowledge
+	I2C_ERR_ARBITRATION,		// arbitration lost, bus glitch or another master
+	I2C_ERR_BUS_STUCK,			// SDA held low even after bus recovery
+	I2C_ERR_BUSY,				// bus manager queue full
+	I2C_PENDING					// queued behind the current bus owner
+} i2c_status_t;
+
+// error and recovery counters, since i2c_init()
+typedef struct
+{
+	uint32_t timeouts;
+	uint32_t nacks;
+	uint32_t arbitration_lost;
+	uint32_t recoveries;		// bus recovery sequences run
+	uint32_t recovery_failures;	// recoveries after which SDA stayed low
+} i2c_error_counters_t;
+
+extern volatile i2c_error_counters_t i2c_error_counters;
+
+#ifdef I2C_INSTRUMENTATION
+// transaction durations are counted in power of two bins of microseconds:
+// bin 0 is below 2 us, bin n is 2^n to 2^(n+1) - 1 us, the last is open ended
+#define I2C_HISTOGRAM_BINS	(12)
+
+// per transaction statistics, since i2c_stats_reset()
+typedef struct
+{
+	uint32_t reads;				// read transactions
+	uint32_t writes;			// write transactions
+	uint32_t failures;			// transactions that did not return I2C_OK
+	uint32_t bytes_read;		// data bytes, without addresses
+	uint32_t bytes_written;
+	uint32_t busy_us;			// total time spent in transactions
+	uint32_t max_us;			// longest transaction
+	uint32_t histogram[I2C_HISTOGRAM_BINS];
+} i2c_stats_t;
+
+extern volatile i2c_stats_t i2c_stats;
+
+/*****************************************************************************
+ * Clears the transaction statistics and the error counters
+ *
+ *****************************************************************************/
+void i2c_stats_reset(void);
+
+/*****************************************************************************
+ * Prints the transaction statistics, error counters and duration
+ * histogram on the uart
+ *
+ *****************************************************************************/
+void i2c_stats_dump(void);
+#endif
+
 /*****************************************************************************
  * Iinitializes the I2C communication via KL25z
  *
@@ -48,33 +110,87 @@
 void i2c_init(void);
 
 /*****************************************************************************
- * Sends I2C start signal and starts i2c communication
+ * Selects the fastest SCL rate not above the requested one, using the
+ * ICR/MULT divider table and the actual bus clock
+ *
+ * Parameters:
+ *   target_hz		highest acceptable SCL frequency in Hz
+ *
+ * Returns:
+ *   achieved SCL frequency in Hz
  *
  *****************************************************************************/
-void i2c_start(void);
+uint32_t i2c_set_speed(uint32_t target_hz);
 
 /*****************************************************************************
- * I2c read setup for reading the data
+ * Computes the F register value of the fastest SCL rate not above the
+ * requested one, without touching the bus
+ *
  * Parameters:
- *   dev      	device address
- *   address    read address
+ *   target_hz		highest acceptable SCL frequency in Hz
+ *   achieved_hz	SCL frequency of the returned setting in Hz
+ *
+ * Returns:
+ *   value for the I2C F register, to be passed to i2c_apply_divider()
+ *
  *****************************************************************************/
-void i2c_read_setup(uint8_t dev, uint8_t address);
+uint8_t i2c_compute_divider(uint32_t target_hz, uint32_t *achieved_hz);
 
 /*****************************************************************************
- * Reads repeatedly from the slave device
+ * Programs a divider computed by i2c_compute_divider(), does nothing when
+ * it is already in use
+ *
  * Parameters:
- *   isLastRead      	flag variable for last read
+ *   divider		value for the I2C F register
+ *   achieved_hz	SCL frequency of this setting in Hz
+ *
+ *****************************************************************************/
+void i2c_apply_divider(uint8_t divider, uint32_t achieved_hz);
+
+/*****************************************************************************
+ * Returns the SCL frequency selected by the last i2c_set_speed() in Hz
+ *
  *****************************************************************************/
-uint8_t i2c_repeated_read(uint8_t isLastRead);
+uint32_t i2c_get_speed(void);
+
+/*****************************************************************************
+ * Frees a bus held by a slave: clocks SCL as a GPIO until SDA is released
+ * (at most 9 clocks), generates a STOP and re-enables the I2C module
+ *
+ * Returns:
+ *   I2C_OK if SDA is released, I2C_ERR_BUS_STUCK otherwise
+ *
+ *****************************************************************************/
+i2c_status_t i2c_recover_bus(void);
+
+/*****************************************************************************
+ * Reads consecutive registers of the slave device in one transaction
+ * Parameters:
+ *   dev      	device address
+ *   address    first register address
+ *   data		buffer for the read bytes
+ *   length		number of bytes to read, at least 1
+ *****************************************************************************/
+i2c_status_t i2c_read_burst(uint8_t dev, uint8_t address, uint8_t *data, uint8_t length);
 
 /*****************************************************************************
  * Reads a byte from the slave device via i2c
  * Parameters:
  *   dev      	device address
  *   address    read address
+ *   data		read byte
+ *****************************************************************************/
+i2c_status_t i2c_read_byte(uint8_t dev, uint8_t address, uint8_t *data);
+
+/*****************************************************************************
+ * Writes consecutive registers of the slave device in one transaction
+ * Parameters:
+ *   dev      	device address
+ *   address    first register address
+ *   data		bytes to write
+ *   length		number of bytes to write
  *****************************************************************************/
-uint8_t i2c_read_byte(uint8_t dev, uint8_t address);
+i2c_status_t i2c_write_burst(uint8_t dev, uint8_t address, const uint8_t *data, uint8_t length);
 
 /*****************************************************************************
  * Writes a byte to the slave device via i2c
@@ -83,6 +199,6 @@ uint8_t i2c_read_byte(uint8_t dev, uint8_t address);
  *   address    read address
  *   data		data to write
  *****************************************************************************/
-void i2c_write_byte(uint8_t dev, uint8_t address, uint8_t data);
+i2c_status_t i2c_write_byte(uint8_t dev, uint8_t address, uint8_t data);
 
 #endif /* I2C_H_ */
@@ -0,0 +1,185 @@
+/*****************************************************************************
+* Copyright (C) 2022 by Bhargav Dharmendra Chauhan
+*
+* Redistribution, modification or use of this software in source or binary
+* forms is permitted as long as the files maintain this copyright. Users are
+* permitted to modify this and use it to learn about the field of embedded
+* software. Bhargav Dharmendra Chauhan and the University of Colorado
+* are not liable for any misuse of this material.
+*
+*****************************************************************************/
+/*****************************************************************************
+*
+*    File name   : i2c_bus.c
+*    Description : shared I2C0 bus manager, device handles and a queue that
+*                  serializes transactions from the main loop and interrupts
+*
+*    Author: Bhargav Dharmendra Chauhan
+*    Tools : MCUXpresso
+*    Date  : 10/19/2026
+*
+*****************************************************************************/
+
+// including required libraries
+#include <stddef.h>
+#include "MKL25Z4.h"
+#include "i2c_bus.h"
+
+#define QUEUE_MASK 	(I2C_BUS_QUEUE_SIZE - 1)
+
+// bus ownership and the transactions waiting for it
+static volatile uint8_t bus_owned = 0;
+static i2c_transaction_t *volatile queue[I2C_BUS_QUEUE_SIZE];
+static volatile uint32_t queue_head = 0, queue_tail = 0;
+
+// takes the bus if it is free, returns 1 on success
+static int bus_acquire(void)
+{
+	uint32_t interrupt_mask;
+	int acquired = 0;
+
+	interrupt_mask = __get_PRIMASK();
+	__disable_irq();
+	if (!bus_owned) {
+		bus_owned = 1;
+		acquired = 1;
+	}
+	__set_PRIMASK(interrupt_mask);
+	return acquired;
+}
+
+// takes the next queued transaction, or releases the bus when there is none
+static i2c_transaction_t *bus_next_or_release(void)
+{
+	i2c_transaction_t *transaction = NULL;
+	uint32_t interrupt_mask;
+
+	interrupt_mask = __get_PRIMASK();
+	__disable_irq();
+	if (queue_tail != queue_head) {
+		transaction = queue[queue_tail & QUEUE_MASK];
+		queue_tail++;
+	} else {
+		bus_owned = 0;
+	}
+	__set_PRIMASK(interrupt_mask);
+	return transaction;
+}
+
+// adds a transaction to the queue, returns 0 if it is full
+static int bus_enqueue(i2c_transaction_t *transaction)
+{
+	uint32_t interrupt_mask;
+	int queued = 0;
+
+	interrupt_mask = __get_PRIMASK();
+	__disable_irq();
+	if (queue_head - queue_tail < I2C_BUS_QUEUE_SIZE) {
+		queue[queue_head & QUEUE_MASK] = transaction;
+		queue_head++;
+		queued = 1;
+	}
+	__set_PRIMASK(interrupt_mask);
+	return queued;
+}
+
+// runs one transfer on an owned bus, with the retry policy of the device
+static i2c_status_t bus_run(const i2c_device_t *device, i2c_direction_t direction,
+		uint8_t reg, uint8_t *data, uint8_t length)
+{
+	i2c_status_t status;
+	uint8_t attempt = 0;
+
+	// only reprogram the divider when the device speed differs
+	i2c_apply_divider(device->divider, device->speed_hz);
+
+	do {
+		if (direction == I2C_BUS_READ)
+			status = i2c_read_burst(device->address, reg, data, length);
+		else
+			status = i2c_write_burst(device->address, reg, data, length);
+	} while (status != I2C_OK && attempt++ < device->retries);
+
+	return status;
+}
+
+// runs the transactions queued while the bus was owned, then releases it
+static void bus_release(void)
+{
+	i2c_transaction_t *transaction;
+
+	while ((transaction = bus_next_or_release()) != NULL) {
+		transaction->status = bus_run(transaction->device, transaction->direction,
+				transaction->reg, transaction->data, transaction->length);
+		if (transaction->callback)
+			transaction->callback(transaction);
+	}
+}
+
+// function definition in header file
+void i2c_bus_device_init(i2c_device_t *device, uint8_t address, uint32_t speed_hz,
+		uint8_t retries)
+{
+	device->address = address;
+	device->retries = retries;
+	device->max_hz = speed_hz;
+	i2c_bus_device_speed(device, speed_hz);
+}
+
+// function definition in header file
+uint32_t i2c_bus_device_speed(i2c_device_t *device, uint32_t speed_hz)
+{
+	// lower of the device rating and of what the bus clock can divide to
+	if (speed_hz > device->max_hz)
+		speed_hz = device->max_hz;
+	device->divider = i2c_compute_divider(speed_hz, &device->speed_hz);
+	return device->speed_hz;
+}
+
+// function definition in header file
+i2c_status_t i2c_bus_submit(i2c_transaction_t *transaction)
+{
+	// bus owned by the interrupted context, it runs the transaction later
+	if (!bus_acquire()) {
+		if (!bus_enqueue(transaction))
+			return I2C_ERR_BUSY;
+		transaction->status = I2C_PENDING;
+		return I2C_PENDING;
+	}
+
+	transaction->status = bus_run(transaction->device, transaction->direction,
+			transaction->reg, transaction->data, transaction->length);
+	if (transaction->callback)
+		transaction->callback(transaction);
+
+	bus_release();
+	return transaction->status;
+}
+
+// function definition in header file
+i2c_status_t i2c_bus_read(const i2c_device_t *device, uint8_t reg, uint8_t *data,
+		uint8_t length)
+{
+	i2c_status_t status;
+
+	if (!bus_acquire())
+		return I2C_PENDING;
+
+	status = bus_run(device, I2C_BUS_READ, reg, data, length);
+	bus_release();
+	return status;
+}
+
+// function definition in header file
+i2c_status_t i2c_bus_write(const i2c_device_t *device, uint8_t reg,
+		const uint8_t *data, uint8_t length)
+{
+	i2c_status_t status;
+
+	if (!bus_acquire())
+		return I2C_PENDING;
+
+	status = bus_run(device, I2C_BUS_WRITE, reg, (uint8_t *)data, length);
+	bus_release();
+	return status;
+}
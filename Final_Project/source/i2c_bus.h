@@ -0,0 +1,141 @@
+/*****************************************************************************
+* Copyright (C) 2022 by Bhargav Dharmendra Chauhan
+*
+* Redistribution, modification or use of this software in source or binary
+* forms is permitted as long as the files maintain this copyright. Users are
+* permitted to modify this and use it to learn about the field of embedded
+* software. Bhargav Dharmendra Chauhan and the University of Colorado
+* are not liable for any misuse of this material.
+*
+*****************************************************************************/
+/*****************************************************************************
+*
+*    File name   : i2c_bus.h
+*    Description : shared I2C0 bus manager, device handles and a queue that
+*                  serializes transactions from the main loop and interrupts
+*
+*    Author: Bhargav Dharmendra Chauhan
+*    Tools : MCUXpresso
+*    Date  : 10/19/2026
+*
+*    The context that starts a transaction on a free bus owns it until the
+*    transaction ends. A transaction submitted while the bus is owned (an
+*    interrupt handler preempting the main loop) is queued and run by the
+*    owner right after its own transaction, then its callback is called.
+*
+*****************************************************************************/
+
+#ifndef I2C_BUS_H_
+#define I2C_BUS_H_
+
+#include <stdint.h>
+#include "i2c.h"
+
+#define I2C_BUS_QUEUE_SIZE 	(8)		// pending transactions, power of two
+
+// one slave on the bus
+typedef struct
+{
+	uint8_t address;		// 8 bit write address
+	uint8_t retries;		// extra attempts after a failed transfer
+	uint8_t divider;		// I2C F register value of the device speed
+	uint32_t speed_hz;		// achieved SCL frequency for this device
+	uint32_t max_hz;		// rated maximum SCL frequency of the device
+} i2c_device_t;
+
+// transfer direction
+typedef enum
+{
+	I2C_BUS_READ,
+	I2C_BUS_WRITE
+} i2c_direction_t;
+
+typedef struct i2c_transaction i2c_transaction_t;
+
+// called when a transaction completes, possibly from another context
+typedef void (*i2c_callback_t)(i2c_transaction_t *transaction);
+
+// one register transfer to or from a device
+struct i2c_transaction
+{
+	const i2c_device_t *device;
+	i2c_direction_t direction;
+	uint8_t reg;				// first register address
+	uint8_t *data;
+	uint8_t length;
+	i2c_callback_t callback;	// may be NULL
+	void *context;				// free for the submitter
+	volatile i2c_status_t status;
+};
+
+/*****************************************************************************
+* Initializes a device handle running at its rated maximum, the divider of
+* its speed is computed once
+*
+* Parameters:
+*   device			device handle
+*   address			8 bit write address of the device
+*   speed_hz		highest SCL frequency supported by the device
+*   retries			extra attempts after a failed transfer
+*
+*****************************************************************************/
+void i2c_bus_device_init(i2c_device_t *device, uint8_t address, uint32_t speed_hz,
+		uint8_t retries);
+
+/*****************************************************************************
+* Changes the SCL frequency of a device, never above its rated maximum
+*
+* Parameters:
+*   device			device handle
+*   speed_hz		requested SCL frequency
+*
+* Returns:
+*   achieved SCL frequency in Hz
+*
+*****************************************************************************/
+uint32_t i2c_bus_device_speed(i2c_device_t *device, uint32_t speed_hz);
+
+/*****************************************************************************
+* Runs a transaction now if the bus is free, otherwise queues it
+*
+* Parameters:
+*   transaction		transaction to run, must stay valid until completion
+*
+* Returns:
+*   status of the transfer, or I2C_PENDING if it was queued, in which case
+*   the callback reports the result
+*
+*****************************************************************************/
+i2c_status_t i2c_bus_submit(i2c_transaction_t *transaction);
+
+/*****************************************************************************
+* Reads registers of a device, for callers that can not wait in a queue
+*
+* Parameters:
+*   device		device handle
+*   reg			first register address
+*   data		buffer for the read bytes
+*   length		number of bytes to read
+*
+* Returns:
+*   status of the transfer, I2C_PENDING if the bus is owned by the context
+*   that was interrupted (nothing is read then)
+*
+*****************************************************************************/
+i2c_status_t i2c_bus_read(const i2c_device_t *device, uint8_t reg, uint8_t *data,
+		uint8_t length);
+
+/*****************************************************************************
+* Writes registers of a device, same rules as i2c_bus_read()
+*
+* Parameters:
+*   device		device handle
+*   reg			first register address
+*   data		bytes to write
+*   length		number of bytes to write
+*
+*****************************************************************************/
+i2c_status_t i2c_bus_write(const i2c_device_t *device, uint8_t reg,
+		const uint8_t *data, uint8_t length);
+
+#endif /* I2C_BUS_H_ */
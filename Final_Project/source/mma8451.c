@@ -0,0 +1,414 @@
+/*****************************************************************************
+* Copyright (C) 2022 by Bhargav Dharmendra Chauhan
+*
+* Redistribution, modification or use of this software in source or binary
+* forms is permitted as long as the files maintain this copyright. Users are
+* permitted to modify this and use it to learn about the field of embedded
+* software. Bhargav Dharmendra Chauhan and the University of Colorado
+* are not liable for any misuse of this material.
+*
+*****************************************************************************/
+/*****************************************************************************
+*
+*    File name   : mma8451.c
+*    Description : MMA8451 register driver with a RAM shadow of the
+*                  configuration registers
+*
+*    Author: Bhargav Dharmendra Chauhan
+*    Tools : MCUXpresso
+*    Date  : 10/19/2026
+*
+*    References: MMA8451Q datasheet, rev 10.3, register map
+*
+*****************************************************************************/
+
+// including required libraries
+#include <stdint.h>
+#include <string.h>
+#include "mma8451.h"
+#include "timebase.h"
+
+#define SHADOW_INDEX(reg) 	((reg) - MMA_SHADOW_FIRST)
+#define MASK(x) 			(1ULL << (x))
+
+// read only or reserved registers inside the shadowed range are never written
+#define READ_ONLY_REGISTERS ( MASK(SHADOW_INDEX(REG_SYSMOD)) \
+							| MASK(SHADOW_INDEX(REG_INT_SOURCE)) \
+							| MASK(SHADOW_INDEX(REG_WHOAMI)) \
+							| MASK(SHADOW_INDEX(0x10)) \
+							| MASK(SHADOW_INDEX(REG_FF_MT_SRC)) \
+							| MASK(SHADOW_INDEX(0x19)) | MASK(SHADOW_INDEX(0x1A)) \
+							| MASK(SHADOW_INDEX(0x1B)) | MASK(SHADOW_INDEX(0x1C)) \
+							| MASK(SHADOW_INDEX(REG_TRANSIENT_SRC)) \
+							| MASK(SHADOW_INDEX(0x22)) )
+
+// estimated current at the lowest and the full internal conversion rate
+#define CURRENT_FLOOR_UA 	(6)
+#define CURRENT_FULL_UA 	(165)
+#define FULL_RATE_HZ 		(1600)
+#define MILLIHZ 			(1000)
+#define LEFT_SHIFT_8 		(8)
+#define SAMPLE_ALIGN 		(4)			// 14 bit samples are left aligned
+
+// automatic range selection, in COUNTS_PER_G units
+#define RANGE_FULL_SCALE(r) ((2 * COUNTS_PER_G) << (r))
+#define RANGE_UP(r) 		(RANGE_FULL_SCALE(r) * 7 / 8)	// close to saturation
+#define RANGE_DOWN(r) 		(RANGE_FULL_SCALE(r) * 3 / 8)	// 3/4 of the lower range
+#define RANGE_HOLD_US 		(1000000)	// peak window before a lower range
+#define RANGE_SETTLE_PERIODS (2)		// wait for the first sample of a new range
+
+// output data rates in mHz, indexed by mma_odr_t
+static const uint32_t odr_millihz[MMA_ODR_COUNT] = { 800000, 400000, 200000, 100000,
+		50000, 12500, 6250, 1563 };
+
+// oversampling ratio per mode and data rate, AN4075 table 2
+static const uint16_t oversampling[MMA_MODS_COUNT][MMA_ODR_COUNT] = {
+	{ 2, 4, 4, 4, 4, 16, 32, 128 },			// normal
+	{ 2, 4, 4, 4, 4, 4, 8, 32 },			// low noise low power
+	{ 2, 4, 8, 16, 32, 128, 256, 1024 },	// high resolution
+	{ 2, 2, 2, 2, 2, 2, 2, 8 },				// low power
+};
+
+// accelerometer on the shared bus
+i2c_device_t mma_device;
+
+// value in the sensor, value wanted, and the registers that differ
+static uint8_t hardware[MMA_SHADOW_SIZE];
+static uint8_t shadow[MMA_SHADOW_SIZE];
+static uint64_t dirty = 0;
+static uint8_t last_transactions = 0;
+
+// automatic range selection state
+static uint8_t auto_range_enabled = 0;
+static int32_t range_peak = 0;
+static uint64_t range_window_start = 0;
+static uint32_t range_switches = 0;
+static uint8_t range_settling = 0;		// output registers may hold the old range
+
+// function definition in header file
+i2c_status_t mma_init(void)
+{
+	i2c_status_t status;
+
+	// the accelerometer supports fast mode
+	i2c_bus_device_init(&mma_device, MMA_ADDR, I2C_SPEED_FAST, MMA_RETRIES);
+
+	// the whole configuration block in one transaction
+	status = i2c_bus_read(&mma_device, MMA_SHADOW_FIRST, hardware, MMA_SHADOW_SIZE);
+	if (status != I2C_OK)
+		return status;
+
+	memcpy(shadow, hardware, MMA_SHADOW_SIZE);
+	dirty = 0;
+	return I2C_OK;
+}
+
+// function definition in header file
+uint8_t mma_reg_get(uint8_t reg)
+{
+	return shadow[SHADOW_INDEX(reg)];
+}
+
+// function definition in header file
+void mma_reg_set(uint8_t reg, uint8_t value)
+{
+	uint8_t index = SHADOW_INDEX(reg);
+
+	shadow[index] = value;
+
+	// a register set back to the value in the sensor needs no write
+	if (shadow[index] != hardware[index])
+		dirty |= MASK(index);
+	else
+		dirty &= ~MASK(index);
+}
+
+// function definition in header file
+void mma_reg_update(uint8_t reg, uint8_t mask, uint8_t value)
+{
+	mma_reg_set(reg, (mma_reg_get(reg) & ~mask) | (value & mask));
+}
+
+// writes the sensor CTRL_REG1 and keeps track of it
+static i2c_status_t write_ctrl1(uint8_t value)
+{
+	i2c_status_t status = i2c_bus_write(&mma_device, REG_CTRL1, &value, 1);
+
+	last_transactions++;
+	if (status == I2C_OK)
+		hardware[SHADOW_INDEX(REG_CTRL1)] = value;
+	return status;
+}
+
+// function definition in header file
+i2c_status_t mma_commit(void)
+{
+	uint64_t pending = dirty & ~READ_ONLY_REGISTERS;
+	uint8_t ctrl1 = SHADOW_INDEX(REG_CTRL1);
+	uint8_t first, last;
+	i2c_status_t status;
+
+	last_transactions = 0;
+	if (pending == 0)
+		return I2C_OK;
+
+	// CTRL_REG1 is written last so the sensor only becomes active once
+	// the rest of the configuration is in place
+	pending &= ~MASK(ctrl1);
+
+	// other registers can only change in standby
+	if (pending && (hardware[ctrl1] & CTRL1_ACTIVE)) {
+		status = write_ctrl1(hardware[ctrl1] & ~CTRL1_ACTIVE);
+		if (status != I2C_OK)
+			return status;
+	}
+
+	// one burst per run of contiguous changed registers
+	for (first = 0; first < MMA_SHADOW_SIZE; first = last + 1) {
+		if (!(pending & MASK(first))) {
+			last = first;
+			continue;
+		}
+		for (last = first; last + 1 < MMA_SHADOW_SIZE && (pending & MASK(last + 1)); last++)
+			;
+
+		status = i2c_bus_write(&mma_device, MMA_SHADOW_FIRST + first, &shadow[first],
+				last - first + 1);
+		last_transactions++;
+		if (status != I2C_OK)
+			return status;
+		memcpy(&hardware[first], &shadow[first], last - first + 1);
+	}
+
+	// final CTRL_REG1 value, also restores active mode after a standby
+	if (hardware[ctrl1] != shadow[ctrl1]) {
+		status = write_ctrl1(shadow[ctrl1]);
+		if (status != I2C_OK)
+			return status;
+	}
+
+	dirty = 0;
+	return I2C_OK;
+}
+
+// function definition in header file
+uint8_t mma_commit_transactions(void)
+{
+	return last_transactions;
+}
+
+// function definition in header file
+i2c_status_t mma_set_mode(const mma_mode_t *mode)
+{
+	mma_reg_update(REG_CTRL1, CTRL1_DR_MASK | CTRL1_LNOISE,
+			(mode->odr << CTRL1_DR_SHIFT) | (mode->low_noise ? CTRL1_LNOISE : 0));
+	mma_reg_update(REG_CTRL2, CTRL2_MODS_MASK, mode->mods);
+	return mma_commit();
+}
+
+// function definition in header file
+void mma_get_mode(mma_mode_t *mode)
+{
+	uint8_t ctrl1 = mma_reg_get(REG_CTRL1);
+
+	mode->odr = (mma_odr_t)((ctrl1 & CTRL1_DR_MASK) >> CTRL1_DR_SHIFT);
+	mode->mods = (mma_mods_t)(mma_reg_get(REG_CTRL2) & CTRL2_MODS_MASK);
+	mode->low_noise = (ctrl1 & CTRL1_LNOISE) ? 1 : 0;
+}
+
+// function definition in header file
+i2c_status_t mma_set_range(mma_range_t range)
+{
+	uint8_t data[SAMPLE_BYTES];
+	mma_range_t previous = mma_get_range();
+	i2c_status_t status;
+
+	mma_reg_update(REG_XYZ_DATA_CFG, XYZ_CFG_FS_MASK, range);
+	if (range > MMA_RANGE_4G)
+		mma_reg_update(REG_CTRL1, CTRL1_LNOISE, 0);
+	status = mma_commit();
+
+	// the output registers still hold a sample of the previous range, which
+	// the new scale would misread. Reading it clears ZYXDR, the first sample
+	// of the new range sets it again, long after this read
+	if (status == I2C_OK && range != previous) {
+		range_settling = 1;
+		i2c_bus_read(&mma_device, REG_XHI, data, sizeof(data));
+	}
+	return status;
+}
+
+// function definition in header file
+mma_range_t mma_get_range(void)
+{
+	return (mma_range_t)(mma_reg_get(REG_XYZ_DATA_CFG) & XYZ_CFG_FS_MASK);
+}
+
+// function definition in header file
+void mma_auto_range(uint8_t enable)
+{
+	auto_range_enabled = enable;
+	range_peak = 0;
+	range_window_start = timebase_now_us();
+}
+
+// function definition in header file
+uint32_t mma_range_switches(void)
+{
+	return range_switches;
+}
+
+// picks the range from the peak of the scaled samples
+static void auto_range(const int16_t xyz[AXIS_COUNT])
+{
+	mma_range_t range = mma_get_range();
+	mma_range_t highest = (mma_reg_get(REG_CTRL1) & CTRL1_LNOISE) ? MMA_RANGE_4G : MMA_RANGE_8G;
+	uint64_t now = timebase_now_us();
+	int32_t peak = 0;
+
+	for (int i = 0; i < AXIS_COUNT; i++) {
+		int32_t value = xyz[i] < 0 ? -xyz[i] : xyz[i];
+		if (value > peak)
+			peak = value;
+	}
+	if (peak > range_peak)
+		range_peak = peak;
+
+	// LNOISE turned on by a mode change caps the range
+	if (range > highest)
+		range = highest;
+	// going up cannot wait, the samples are about to clip
+	else if (peak >= RANGE_UP(range) && range < highest)
+		range++;
+	// going down once the whole window fitted the lower range
+	else if (now - range_window_start >= RANGE_HOLD_US) {
+		if (range_peak < RANGE_DOWN(range) && range > MMA_RANGE_2G)
+			range--;
+		range_peak = 0;
+		range_window_start = now;
+	}
+
+	if (range != mma_get_range() && mma_set_range(range) == I2C_OK) {
+		range_switches++;
+		range_peak = 0;
+		range_window_start = now;
+	}
+}
+
+// function definition in header file
+uint32_t mma_odr_period_us(mma_odr_t odr)
+{
+	return (uint32_t)(1000000ULL * MILLIHZ / odr_millihz[odr]);
+}
+
+// function definition in header file
+uint16_t mma_oversampling(const mma_mode_t *mode)
+{
+	return oversampling[mode->mods][mode->odr];
+}
+
+// function definition in header file
+uint16_t mma_mode_current_ua(const mma_mode_t *mode)
+{
+	// internal conversions per second, capped at the full rate
+	uint32_t rate_millihz = odr_millihz[mode->odr] * mma_oversampling(mode);
+
+	if (rate_millihz > FULL_RATE_HZ * MILLIHZ)
+		rate_millihz = FULL_RATE_HZ * MILLIHZ;
+	return CURRENT_FLOOR_UA + (CURRENT_FULL_UA - CURRENT_FLOOR_UA) * rate_millihz
+			/ (FULL_RATE_HZ * MILLIHZ);
+}
+
+// function definition in header file
+void mma_unpack_sample(const uint8_t data[SAMPLE_BYTES], int16_t xyz[AXIS_COUNT])
+{
+	// extracing 16 bits of data and align for 14 bits
+	for (int i = 0; i < AXIS_COUNT; i++)
+		xyz[i] = ((int16_t)((data[2*i] << LEFT_SHIFT_8) | data[2*i+1])) / SAMPLE_ALIGN;
+}
+
+// sensor interface: shadow load and activation
+static i2c_status_t sensor_init(void)
+{
+	i2c_status_t status = mma_init();
+
+	if (status != I2C_OK)
+		return status;
+
+	// active mode, no write if it already is
+	mma_reg_update(REG_CTRL1, CTRL1_ACTIVE, CTRL1_ACTIVE);
+	return mma_commit();
+}
+
+// waits for the first sample after a range switch, at most a few sample periods
+static i2c_status_t wait_new_sample(void)
+{
+	mma_mode_t mode;
+	uint8_t status_register;
+	uint64_t start = timebase_now_us();
+	uint32_t timeout_us;
+	i2c_status_t status;
+
+	mma_get_mode(&mode);
+	timeout_us = RANGE_SETTLE_PERIODS * mma_odr_period_us(mode.odr);
+	do {
+		status = i2c_bus_read(&mma_device, REG_STATUS, &status_register, 1);
+		if (status != I2C_OK)
+			return status;
+		if (status_register & STATUS_ZYXDR) {
+			range_settling = 0;
+			return I2C_OK;
+		}
+	} while (timebase_now_us() - start < timeout_us);
+
+	return I2C_ERR_TIMEOUT;
+}
+
+// sensor interface: the six data registers in one transaction
+static i2c_status_t sensor_read_burst(int16_t xyz[AXIS_COUNT])
+{
+	uint8_t data[SAMPLE_BYTES];
+	mma_range_t range = mma_get_range();
+	i2c_status_t status = range_settling ? wait_new_sample() : I2C_OK;
+
+	if (status == I2C_OK)
+		status = i2c_bus_read(&mma_device, REG_XHI, data, sizeof(data));
+	if (status != I2C_OK)
+		return status;
+
+	// same unit on every range, COUNTS_PER_G is the +/-2g resolution
+	mma_unpack_sample(data, xyz);
+	for (int i = 0; i < AXIS_COUNT; i++)
+		xyz[i] = (int16_t)(xyz[i] * (1 << range));
+
+	if (auto_range_enabled)
+		auto_range(xyz);
+	return status;
+}
+
+// sensor interface: slowest data rate that still delivers a new sample
+// every period
+static i2c_status_t sensor_configure(const sensor_config_t *config)
+{
+	mma_mode_t mode;
+
+	mma_get_mode(&mode);
+	mode.odr = MMA_ODR_800HZ;
+	while (mode.odr + 1 < MMA_ODR_COUNT
+			&& mma_odr_period_us((mma_odr_t)(mode.odr + 1)) <= config->period_us)
+		mode.odr++;
+	if (config->oversampling < MMA_MODS_COUNT)
+		mode.mods = (mma_mods_t)config->oversampling;
+	if (config->low_noise != SENSOR_KEEP)
+		mode.low_noise = config->low_noise;
+
+	return mma_set_mode(&mode);
+}
+
+const sensor_driver_t mma8451_sensor = {
+	"MMA8451",
+	sensor_init,
+	sensor_read_burst,
+	sensor_configure,
+	timebase_now_us,
+};
@@ -0,0 +1,301 @@
+/*****************************************************************************
+* Copyright (C) 2022 by Bhargav Dharmendra Chauhan
+*
+* Redistribution, modification or use of this software in source or binary
+* forms is permitted as long as the files maintain this copyright. Users are
+* permitted to modify this and use it to learn about the field of embedded
+* software. Bhargav Dharmendra Chauhan and the University of Colorado
+* are not liable for any misuse of this material.
+*
+*****************************************************************************/
+/*****************************************************************************
+*
+*    File name   : mma8451.h
+*    Description : MMA8451 register driver with a RAM shadow of the
+*                  configuration registers
+*
+*    Author: Bhargav Dharmendra Chauhan
+*    Tools : MCUXpresso
+*    Date  : 10/19/2026
+*
+*    Configuration changes are staged in the shadow with mma_reg_set() or
+*    mma_reg_update() and written by mma_commit(): registers whose value
+*    does not change are skipped and contiguous changed registers are
+*    written in one auto-increment transaction.
+*
+*****************************************************************************/
+
+#ifndef MMA8451_H_
+#define MMA8451_H_
+
+#include <stdint.h>
+#include "i2c.h"
+#include "i2c_bus.h"
+#include "sensor.h"
+
+// device address and identification
+#define MMA_ADDR 			(0x3A)		// mma sensor address
+#define WHOAMI 				(0x1A)
+#define MMA_RETRIES 		(1)			// extra attempts after a failed transfer
+
+// data and status registers
+#define REG_STATUS 			(0x00)
+#define REG_XHI 			(0x01)		// xhi register address
+#define REG_SYSMOD 			(0x0B)
+#define REG_INT_SOURCE 		(0x0C)
+#define REG_WHOAMI 			(0x0D)		// who am i register for testing
+
+// configuration registers, all kept in the shadow
+#define REG_F_SETUP 		(0x09)
+#define REG_TRIG_CFG 		(0x0A)
+#define REG_XYZ_DATA_CFG 	(0x0E)
+#define REG_HP_FILTER 		(0x0F)
+#define REG_PL_CFG 			(0x11)
+#define REG_PL_COUNT 		(0x12)
+#define REG_PL_BF_ZCOMP 	(0x13)
+#define REG_PL_THS 			(0x14)
+#define REG_FF_MT_CFG 		(0x15)
+#define REG_FF_MT_SRC 		(0x16)
+#define REG_FF_MT_THS 		(0x17)
+#define REG_FF_MT_COUNT 	(0x18)
+#define REG_TRANSIENT_CFG 	(0x1D)
+#define REG_TRANSIENT_SRC 	(0x1E)
+#define REG_TRANSIENT_THS 	(0x1F)
+#define REG_TRANSIENT_COUNT (0x20)
+#define REG_PULSE_CFG 		(0x21)
+#define REG_ASLP_COUNT 		(0x29)
+#define REG_CTRL1 			(0x2A)		// CTRL1 register address
+#define REG_CTRL2 			(0x2B)
+#define REG_CTRL3 			(0x2C)
+#define REG_CTRL4 			(0x2D)
+#define REG_CTRL5 			(0x2E)
+#define REG_OFF_X 			(0x2F)
+#define REG_OFF_Y 			(0x30)
+#define REG_OFF_Z 			(0x31)
+
+// sample registers, starting at REG_XHI, X, Y and Z MSB first
+#define SAMPLE_BYTES 		(6)
+
+#define MMA_SHADOW_FIRST 	(REG_F_SETUP)
+#define MMA_SHADOW_LAST 	(REG_OFF_Z)
+#define MMA_SHADOW_SIZE 	(MMA_SHADOW_LAST - MMA_SHADOW_FIRST + 1)
+
+// CTRL_REG1 and CTRL_REG2 fields
+#define CTRL1_ACTIVE 		(0x01)
+#define CTRL1_LNOISE 		(0x04)
+#define CTRL1_DR_MASK 		(0x38)
+#define CTRL1_DR_SHIFT 		(3)
+#define CTRL2_MODS_MASK 	(0x03)
+
+// XYZ_DATA_CFG fields
+#define XYZ_CFG_FS_MASK 	(0x03)
+
+// STATUS fields
+#define STATUS_ZYXDR 		(0x08)		// new X, Y and Z sample available
+
+// output data rates, CTRL_REG1 DR field
+typedef enum
+{
+	MMA_ODR_800HZ = 0,
+	MMA_ODR_400HZ,
+	MMA_ODR_200HZ,
+	MMA_ODR_100HZ,
+	MMA_ODR_50HZ,
+	MMA_ODR_12_5HZ,
+	MMA_ODR_6_25HZ,
+	MMA_ODR_1_56HZ,
+	MMA_ODR_COUNT
+} mma_odr_t;
+
+// oversampling modes while active, CTRL_REG2 MODS field
+typedef enum
+{
+	MMA_MODS_NORMAL = 0,
+	MMA_MODS_LOW_NOISE_LOW_POWER,
+	MMA_MODS_HIGH_RESOLUTION,
+	MMA_MODS_LOW_POWER,
+	MMA_MODS_COUNT
+} mma_mods_t;
+
+// full scale ranges, XYZ_DATA_CFG FS field
+typedef enum
+{
+	MMA_RANGE_2G = 0,		// 4096 counts per g
+	MMA_RANGE_4G,			// 2048 counts per g
+	MMA_RANGE_8G,			// 1024 counts per g
+	MMA_RANGE_COUNT
+} mma_range_t;
+
+// acquisition mode of the sensor
+typedef struct
+{
+	mma_odr_t odr;
+	mma_mods_t mods;
+	uint8_t low_noise;		// LNOISE, only valid on the +/-2g and +/-4g ranges
+} mma_mode_t;
+
+// accelerometer handle on the shared i2c bus, set up by mma_init()
+extern i2c_device_t mma_device;
+
+// sensor interface implementation of the MMA8451
+extern const sensor_driver_t mma8451_sensor;
+
+/*****************************************************************************
+* Sets up the device handle and loads the shadow from the sensor in one
+* burst read
+*
+* Returns:
+*   status of the read
+*
+*****************************************************************************/
+i2c_status_t mma_init(void);
+
+/*****************************************************************************
+* Returns the shadow value of a configuration register
+*
+* Parameters:
+*   reg			register address, MMA_SHADOW_FIRST to MMA_SHADOW_LAST
+*
+*****************************************************************************/
+uint8_t mma_reg_get(uint8_t reg);
+
+/*****************************************************************************
+* Stages a new value of a configuration register, written by mma_commit()
+*
+* Parameters:
+*   reg			register address, MMA_SHADOW_FIRST to MMA_SHADOW_LAST
+*   value		new register value
+*
+*****************************************************************************/
+void mma_reg_set(uint8_t reg, uint8_t value);
+
+/*****************************************************************************
+* Stages a change of some bits of a configuration register, without
+* reading it over the bus
+*
+* Parameters:
+*   reg			register address, MMA_SHADOW_FIRST to MMA_SHADOW_LAST
+*   mask		bits to change
+*   value		new value of those bits
+*
+*****************************************************************************/
+void mma_reg_update(uint8_t reg, uint8_t mask, uint8_t value);
+
+/*****************************************************************************
+* Writes the staged changes. The sensor is put in standby around the
+* writes when it is active, as required by the datasheet
+*
+* Returns:
+*   status of the writes, the staged changes are kept on failure
+*
+*****************************************************************************/
+i2c_status_t mma_commit(void);
+
+/*****************************************************************************
+* Returns the number of bus transactions made by the last mma_commit()
+*
+*****************************************************************************/
+uint8_t mma_commit_transactions(void);
+
+/*****************************************************************************
+* Changes the output data rate and oversampling mode in one commit
+*
+* Parameters:
+*   mode		new acquisition mode
+*
+* Returns:
+*   status of the commit
+*
+*****************************************************************************/
+i2c_status_t mma_set_mode(const mma_mode_t *mode);
+
+/*****************************************************************************
+* Returns the acquisition mode held in the shadow
+*
+* Parameters:
+*   mode		filled by the function
+*
+*****************************************************************************/
+void mma_get_mode(mma_mode_t *mode);
+
+/*****************************************************************************
+* Changes the full scale range, one staged register and one commit. The
+* +/-8g range turns LNOISE off, it is only valid up to +/-4g
+*
+* Parameters:
+*   range		new full scale range
+*
+* Returns:
+*   status of the commit, the next sensor read waits for a sample taken
+*   in the new range
+*
+*****************************************************************************/
+i2c_status_t mma_set_range(mma_range_t range);
+
+/*****************************************************************************
+* Returns the full scale range held in the shadow
+*
+*****************************************************************************/
+mma_range_t mma_get_range(void);
+
+/*****************************************************************************
+* Enables the automatic range selection of mma8451_sensor. The range goes
+* up as soon as a sample gets close to the full scale, and down once the
+* peak has stayed well inside the lower range for a while. Samples of
+* mma8451_sensor are always scaled to COUNTS_PER_G, whatever the range
+*
+* Parameters:
+*   enable		1 to switch the range automatically, 0 to keep it
+*
+*****************************************************************************/
+void mma_auto_range(uint8_t enable);
+
+/*****************************************************************************
+* Returns the number of range changes made by the automatic selection
+*
+*****************************************************************************/
+uint32_t mma_range_switches(void);
+
+/*****************************************************************************
+* Returns the period of an output data rate in microseconds
+*
+* Parameters:
+*   odr			output data rate
+*
+*****************************************************************************/
+uint32_t mma_odr_period_us(mma_odr_t odr);
+
+/*****************************************************************************
+* Returns the internal oversampling ratio of a mode, from AN4075
+*
+* Parameters:
+*   mode		acquisition mode
+*
+*****************************************************************************/
+uint16_t mma_oversampling(const mma_mode_t *mode);
+
+/*****************************************************************************
+* Estimates the supply current of a mode. The datasheet gives 165 uA at
+* the full internal conversion rate of 1600 Hz (ODR x oversampling) and a
+* few uA at the lowest, the estimate is linear in between
+*
+* Parameters:
+*   mode		acquisition mode
+*
+* Returns:
+*   estimated active supply current in uA
+*
+*****************************************************************************/
+uint16_t mma_mode_current_ua(const mma_mode_t *mode);
+
+/*****************************************************************************
+* Converts the data registers to 14 bit samples
+*
+* Parameters:
+*   data		SAMPLE_BYTES read from REG_XHI
+*   xyz			array of AXIS_COUNT samples, filled by the function
+*
+*****************************************************************************/
+void mma_unpack_sample(const uint8_t data[SAMPLE_BYTES], int16_t xyz[AXIS_COUNT]);
+
+#endif /* MMA8451_H_ */
@@ -0,0 +1,195 @@
+/*****************************************************************************
+* Copyright (C) 2022 by Bhargav Dharmendra Chauhan
+*
+* Redistribution, modification or use of this software in source or binary
+* forms is permitted as long as the files maintain this copyright. Users are
+* permitted to modify this and use it to learn about the field of embedded
+* software. Bhargav Dharmendra Chauhan and the University of Colorado
+* are not liable for any misuse of this material.
+*
+*****************************************************************************/
+/*****************************************************************************
+*
+*    File name   : motion.c
+*    Description : wake up on movement using the MMA8451 transient detection
+*                  engine, routed to INT1 (PTA14)
+*
+*    Author: Bhargav Dharmendra Chauhan
+*    Tools : MCUXpresso
+*    Date  : 10/19/2026
+*
+*    References: MMA8451Q datasheet, rev 10.3, transient detection registers
+*                NXP AN4071, high pass filtered data and transient detection
+*
+*****************************************************************************/
+
+// including required libraries
+#include "MKL25Z4.h"
+#include <stdint.h>
+#include "motion.h"
+#include "mma8451.h"
+#include "timebase.h"
+
+#define INT1_PIN 				(14)		// MMA8451 INT1 on the FRDM-KL25Z
+#define FALLING_EDGE_INTERRUPT 	(10)		// INT1 is active low, push-pull
+#define THRESHOLD_MAX 			(0x7F)
+
+// TRANSIENT_CFG, CTRL_REG4 and CTRL_REG5 fields
+#define TRANSIENT_ELE 			(0x10)		// latch the event until the source is read
+#define TRANSIENT_AXES_MASK 	(0x0E)
+#define INT_TRANS 				(0x20)		// transient bit in CTRL_REG4/CTRL_REG5
+
+// set by the pin interrupt, cleared when the event is acknowledged
+static volatile uint8_t event_pending = 0;
+static volatile uint64_t last_motion_us = 0;
+static volatile motion_stats_t stats;
+static uint64_t start_us = 0;
+static uint32_t idle_timeout_us = 0;
+static mma_odr_t sleep_odr = MMA_ODR_800HZ;
+static uint8_t enabled = 0;
+
+// reads a 64 bit value shared with the interrupt handler
+static uint64_t read_shared(volatile uint64_t *value)
+{
+	uint32_t masking_state = __get_PRIMASK();
+	uint64_t copy;
+
+	__disable_irq();
+	copy = *value;
+	__set_PRIMASK(masking_state);
+	return copy;
+}
+
+// function definition in header file
+int motion_init(const motion_config_t *config)
+{
+	uint32_t threshold = (config->threshold_mg + MOTION_MG_PER_COUNT - 1) / MOTION_MG_PER_COUNT;
+	uint8_t source;
+
+	if (threshold == 0)
+		threshold = 1;
+	if (threshold > THRESHOLD_MAX)
+		threshold = THRESHOLD_MAX;
+
+	// high pass filtered detection on the selected axes, latched
+	mma_reg_set(REG_TRANSIENT_CFG, TRANSIENT_ELE | (config->axes & TRANSIENT_AXES_MASK));
+	mma_reg_set(REG_TRANSIENT_THS, threshold);
+	mma_reg_set(REG_TRANSIENT_COUNT, config->debounce_count);
+
+	// transient interrupt enabled and routed to INT1
+	mma_reg_update(REG_CTRL4, INT_TRANS, INT_TRANS);
+	mma_reg_update(REG_CTRL5, INT_TRANS, INT_TRANS);
+	if (mma_commit() != I2C_OK)
+		return 0;
+
+	// release an event latched before the configuration
+	if (i2c_bus_read(&mma_device, REG_TRANSIENT_SRC, &source, 1) != I2C_OK)
+		return 0;
+
+	idle_timeout_us = config->idle_timeout_us;
+	sleep_odr = config->odr;
+	start_us = timebase_now_us();
+	last_motion_us = start_us;
+	stats.asleep_us = 0;
+	stats.wakeups = 0;
+	stats.events = 0;
+	event_pending = 0;
+
+	// INT1 pin shares the port A interrupt with the tactile switch
+	SIM->SCGC5 |= SIM_SCGC5_PORTA_MASK;
+	PORTA->PCR[INT1_PIN] = PORT_PCR_MUX(1) | PORT_PCR_ISF_MASK
+			| PORT_PCR_IRQC(FALLING_EDGE_INTERRUPT);
+	NVIC_EnableIRQ(PORTA_IRQn);
+
+	enabled = 1;
+	return 1;
+}
+
+// function definition in header file
+void motion_poll(void)
+{
+	uint8_t source;
+
+	if (!event_pending)
+		return;
+
+	// reading the source releases INT1, the flag is cleared first so an
+	// event arriving meanwhile is not lost
+	event_pending = 0;
+	if (i2c_bus_read(&mma_device, REG_TRANSIENT_SRC, &source, 1) != I2C_OK)
+		event_pending = 1;
+}
+
+// function definition in header file
+int motion_is_idle(void)
+{
+	// never idle without the interrupt to wake up again
+	if (!enabled)
+		return 0;
+	return timebase_now_us() - read_shared(&last_motion_us) > idle_timeout_us;
+}
+
+// function definition in header file
+uint64_t motion_sleep(void)
+{
+	uint64_t sleep_start, slept;
+	uint32_t masking_state;
+	mma_mode_t awake_mode, sleep_mode;
+
+	// the debounce and the high pass cutoff were chosen for sleep_odr, a
+	// failed switch still sleeps, only less precisely
+	mma_get_mode(&awake_mode);
+	sleep_mode = awake_mode;
+	sleep_mode.odr = sleep_odr;
+	if (sleep_mode.odr != awake_mode.odr)
+		mma_set_mode(&sleep_mode);
+
+	// a movement already reported does not need to wait
+	motion_poll();
+	sleep_start = timebase_now_us();
+
+	// plain sleep, the bus clock and the UART keep running
+	SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;
+
+	// WFI also returns on an interrupt held off by PRIMASK, so checking the
+	// flag with interrupts masked cannot miss a wake up
+	masking_state = __get_PRIMASK();
+	__disable_irq();
+	while (!event_pending) {
+		__WFI();
+		__enable_irq();
+		__disable_irq();
+	}
+	__set_PRIMASK(masking_state);
+
+	slept = timebase_now_us() - sleep_start;
+	stats.asleep_us += slept;
+	stats.wakeups++;
+	motion_poll();
+
+	// back to the rate of the acquisition
+	if (sleep_mode.odr != awake_mode.odr)
+		mma_set_mode(&awake_mode);
+	return slept;
+}
+
+// function definition in header file
+void motion_get_stats(motion_stats_t *out)
+{
+	uint32_t masking_state = __get_PRIMASK();
+
+	__disable_irq();
+	out->asleep_us = stats.asleep_us;
+	out->wakeups = stats.wakeups;
+	out->events = stats.events;
+	__set_PRIMASK(masking_state);
+	out->total_us = timebase_now_us() - start_us;
+}
+
+// function definition in header file
+void motion_interrupt(void)
+{
+	event_pending = 1;
+	stats.events++;
+	last_motion_us = timebase_now_us();
+}
@@ -0,0 +1,119 @@
+/*****************************************************************************
+* Copyright (C) 2022 by Bhargav Dharmendra Chauhan
+*
+* Redistribution, modification or use of this software in source or binary
+* forms is permitted as long as the files maintain this copyright. Users are
+* permitted to modify this and use it to learn about the field of embedded
+* software. Bhargav Dharmendra Chauhan and the University of Colorado
+* are not liable for any misuse of this material.
+*
+*****************************************************************************/
+/*****************************************************************************
+*
+*    File name   : motion.h
+*    Description : wake up on movement using the MMA8451 transient detection
+*                  engine, routed to INT1 (PTA14)
+*
+*    Author: Bhargav Dharmendra Chauhan
+*    Tools : MCUXpresso
+*    Date  : 10/19/2026
+*
+*    The transient engine compares the high pass filtered acceleration with
+*    a threshold, so gravity and a constant tilt do not count as movement.
+*    When no movement was seen for the idle timeout the main loop calls
+*    motion_sleep(), which waits in sleep mode until the next event.
+*
+*    The debounce count and the high pass cutoff of the engine both scale
+*    with the output data rate, which the acquisition lowers while still.
+*    motion_sleep() therefore runs the sensor at the configured rate and
+*    puts the acquisition mode back once woken, so the wake up sensitivity
+*    does not depend on the sampling rate before the sleep.
+*
+*****************************************************************************/
+
+#ifndef MOTION_H_
+#define MOTION_H_
+
+#include <stdint.h>
+#include "mma8451.h"
+
+// axes taking part in the detection, can be combined
+#define MOTION_AXIS_X 			(0x02)
+#define MOTION_AXIS_Y 			(0x04)
+#define MOTION_AXIS_Z 			(0x08)
+#define MOTION_AXIS_ALL 		(MOTION_AXIS_X | MOTION_AXIS_Y | MOTION_AXIS_Z)
+
+// threshold step of the transient engine
+#define MOTION_MG_PER_COUNT 	(63)
+
+typedef struct
+{
+	uint16_t threshold_mg;		// movement above this wakes the board, up to 8000
+	uint8_t debounce_count;		// consecutive samples above the threshold at odr
+	uint8_t axes;				// MOTION_AXIS_* bits
+	uint32_t idle_timeout_us;	// quiet time before motion_is_idle() is true
+	mma_odr_t odr;				// sensor rate while asleep
+} motion_config_t;
+
+typedef struct
+{
+	uint64_t asleep_us;			// time spent in motion_sleep()
+	uint64_t total_us;			// time since motion_init()
+	uint32_t wakeups;			// sleeps ended by a movement
+	uint32_t events;			// transient interrupts seen
+} motion_stats_t;
+
+/*****************************************************************************
+* Configures the transient engine and the INT1 pin interrupt, the sensor
+* must already be initialized with init_mma()
+*
+* Parameters:
+*   config			detection settings
+*
+* Returns:
+*   1 on success, 0 if the configuration could not be written
+*
+*****************************************************************************/
+int motion_init(const motion_config_t *config);
+
+/*****************************************************************************
+* Acknowledges a pending transient event at the sensor so the next one
+* raises INT1 again, to be called from the main loop
+*
+*****************************************************************************/
+void motion_poll(void);
+
+/*****************************************************************************
+* Returns 1 if no movement was detected for the idle timeout, always 0
+* when motion_init() failed
+*
+*****************************************************************************/
+int motion_is_idle(void);
+
+/*****************************************************************************
+* Sleeps until the sensor reports a movement, interrupts keep being
+* serviced meanwhile. The sensor runs at the configured rate during the
+* sleep and returns to its previous mode afterwards
+*
+* Returns:
+*   time spent asleep in microseconds
+*
+*****************************************************************************/
+uint64_t motion_sleep(void);
+
+/*****************************************************************************
+* Returns the sleep and activity counters
+*
+* Parameters:
+*   stats			filled by the function
+*
+*****************************************************************************/
+void motion_get_stats(motion_stats_t *stats);
+
+/*****************************************************************************
+* Handles the INT1 pin, called by PORTA_IRQHandler() in interrupt context
+*
+*****************************************************************************/
+void motion_interrupt(void);
+
+#endif /* MOTION_H_ */
@@ -0,0 +1,120 @@
+/*****************************************************************************
+* Copyright (C) 2022 by Bhargav Dharmendra Chauhan
+*
+* Redistribution, modification or use of this software in source or binary
+* forms is permitted as long as the files maintain this copyright. Users are
+* permitted to modify this and use it to learn about the field of embedded
+* software. Bhargav Dharmendra Chauhan and the University of Colorado
+* are not liable for any misuse of this material.
+*
+*****************************************************************************/
+/*****************************************************************************
+*
+*    File name   : pipeline.c
+*    Description : per sample processing of the main loop, shared with the
+*                  host pipeline
+*
+*    Author: Bhargav Dharmendra Chauhan
+*    Tools : MCUXpresso
+*    Date  : 10/19/2026
+*
+*****************************************************************************/
+
+// including required libraries
+#include <stdint.h>
+#include "pipeline.h"
+
+#define MEDIAN_TAPS 		(3)			// rejects single sample spikes
+#define IIR_SHIFT 			(2)			// 1/4 of every new sample
+
+// recomputes the gains of an estimator for a new sample period, keeping
+// its angle and rate
+static void retune_estimator(angle_estimator_t *estimator, uint32_t period_us)
+{
+	angle_estimator_t tuned;
+
+	angle_estimator_init(&tuned, PIPELINE_PROCESS_NOISE, PIPELINE_MEASUREMENT_NOISE,
+			period_us);
+	angle_estimator_set_gains(estimator, tuned.alpha, tuned.beta);
+}
+
+// function definition in header file
+void pipeline_init(pipeline_t *pipeline)
+{
+	for (int axis = 0; axis < AXIS_COUNT; axis++) {
+		filter_chain_init(&pipeline->axis_filter[axis]);
+		filter_chain_add(&pipeline->axis_filter[axis], FILTER_MEDIAN, MEDIAN_TAPS);
+		filter_chain_add(&pipeline->axis_filter[axis], FILTER_IIR, IIR_SHIFT);
+	}
+	pipeline->reference = 0;
+	pipeline->target = 0;
+	pipeline->previous_us = 0;
+}
+
+// function definition in header file
+void pipeline_filter(pipeline_t *pipeline, sample_t *sample)
+{
+	// filter every axis before the angle calculation
+	for (int axis = 0; axis < AXIS_COUNT; axis++)
+		sample->xyz[axis] = filter_chain_apply(&pipeline->axis_filter[axis],
+				sample->raw[axis]);
+
+	compute_tilt(sample->xyz, &sample->tilt);
+}
+
+// function definition in header file
+void pipeline_start(pipeline_t *pipeline, angle_t reference, angle_t target)
+{
+	uint32_t period_us;
+
+	pipeline->reference = reference;
+	pipeline->target = target;
+	pipeline->previous_us = 0;
+
+	// sampling rate follows the movement, starting at the moving rate
+	acquisition_init(&pipeline->acquisition, ACQUISITION_MOVING);
+	period_us = acquisition_period_us(&pipeline->acquisition);
+
+	// track angle and rate to settle quickly without a heavy low pass
+	angle_estimator_init(&pipeline->roll_estimator, PIPELINE_PROCESS_NOISE,
+			PIPELINE_MEASUREMENT_NOISE, period_us);
+	angle_estimator_init(&pipeline->pitch_estimator, PIPELINE_PROCESS_NOISE,
+			PIPELINE_MEASUREMENT_NOISE, period_us);
+}
+
+// function definition in header file
+void pipeline_restart(pipeline_t *pipeline)
+{
+	pipeline->previous_us = 0;
+}
+
+// function definition in header file
+int pipeline_step(pipeline_t *pipeline, measurement_t *measurement)
+{
+	sample_t *sample = &measurement->sample;
+	acquisition_t *acquisition = &pipeline->acquisition;
+	uint32_t dt_us;
+
+	pipeline_filter(pipeline, sample);
+
+	// real time between samples, the loop period varies with the printing
+	dt_us = pipeline->previous_us ? (uint32_t)(sample->timestamp_us - pipeline->previous_us)
+			: acquisition_period_us(acquisition);
+	pipeline->previous_us = sample->timestamp_us;
+
+	measurement->roll = angle_estimator_update(&pipeline->roll_estimator,
+			sample->tilt.roll, dt_us) - pipeline->reference;
+	measurement->pitch = angle_estimator_update(&pipeline->pitch_estimator,
+			sample->tilt.pitch, dt_us);
+	measurement->on_target = target_reached(measurement->roll, pipeline->target,
+			PIPELINE_TARGET_TOLERANCE);
+
+	// faster sampling while moving and close to the target
+	if (!acquisition_update(acquisition, angle_estimator_rate(&pipeline->roll_estimator),
+			measurement->roll - pipeline->target, sample->timestamp_us))
+		return 0;
+
+	retune_estimator(&pipeline->roll_estimator, acquisition_period_us(acquisition));
+	retune_estimator(&pipeline->pitch_estimator, acquisition_period_us(acquisition));
+	return 1;
+}
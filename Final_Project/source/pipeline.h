@@ -0,0 +1,110 @@
+/*****************************************************************************
+* Copyright (C) 2022 by Bhargav Dharmendra Chauhan
+*
+* Redistribution, modification or use of this software in source or binary
+* forms is permitted as long as the files maintain this copyright. Users are
+* permitted to modify this and use it to learn about the field of embedded
+* software. Bhargav Dharmendra Chauhan and the University of Colorado
+* are not liable for any misuse of this material.
+*
+*****************************************************************************/
+/*****************************************************************************
+*
+*    File name   : pipeline.h
+*    Description : per sample processing of the main loop: filters, tilt,
+*                  angle estimators, target decision and sampling rate,
+*                  free of hardware access so it also builds on a host
+*
+*    Author: Bhargav Dharmendra Chauhan
+*    Tools : MCUXpresso
+*    Date  : 10/19/2026
+*
+*    The caller reads the samples, the pipeline only reaches the sensor
+*    through the active driver when the sampling rate changes.
+*
+*****************************************************************************/
+
+#ifndef PIPELINE_H_
+#define PIPELINE_H_
+
+#include <stdint.h>
+#include "accel_filter.h"
+#include "acquisition.h"
+#include "angle_estimator.h"
+#include "sample_bus.h"
+#include "tilt.h"
+
+#define PIPELINE_TARGET_TOLERANCE 	(50)		// target is reached within +/-0.5 degree
+#define PIPELINE_PROCESS_NOISE 		(20000)		// expected angular acceleration, cdeg/s^2
+#define PIPELINE_MEASUREMENT_NOISE 	(30)		// angle noise after the sample filters, cdeg
+
+// state of the chain
+typedef struct
+{
+	filter_chain_t axis_filter[AXIS_COUNT];	// per axis sample filters
+	angle_estimator_t roll_estimator;
+	angle_estimator_t pitch_estimator;
+	acquisition_t acquisition;				// sampling rate of the loop
+	angle_t reference;						// roll of the reference position
+	angle_t target;							// roll target, from the reference
+	uint64_t previous_us;					// time of the last sample, 0 to restart
+} pipeline_t;
+
+/*****************************************************************************
+* Sets up the sample filters: single sample spikes are rejected, then the
+* remaining jitter is smoothed
+*
+* Parameters:
+*   pipeline		pipeline instance
+*
+*****************************************************************************/
+void pipeline_init(pipeline_t *pipeline);
+
+/*****************************************************************************
+* Filters the calibrated counts of a sample and computes its tilt
+*
+* Parameters:
+*   pipeline		pipeline instance
+*   sample			sample with raw filled in, xyz and tilt are written
+*
+*****************************************************************************/
+void pipeline_filter(pipeline_t *pipeline, sample_t *sample);
+
+/*****************************************************************************
+* Starts the estimators and the acquisition at the moving rate, which
+* configures the active sensor for it
+*
+* Parameters:
+*   pipeline		pipeline instance
+*   reference		roll of the reference position, cdeg
+*   target			roll target from the reference, cdeg
+*
+*****************************************************************************/
+void pipeline_start(pipeline_t *pipeline, angle_t reference, angle_t target);
+
+/*****************************************************************************
+* Makes the next sample restart the estimators from the nominal period,
+* e.g. after sleeping
+*
+* Parameters:
+*   pipeline		pipeline instance
+*
+*****************************************************************************/
+void pipeline_restart(pipeline_t *pipeline);
+
+/*****************************************************************************
+* Processes one sample: filters, tilt, estimators, target decision and
+* sampling rate
+*
+* Parameters:
+*   pipeline		pipeline instance
+*   measurement		sample with timestamp and raw filled in, the rest of
+*					the measurement is written
+*
+* Returns:
+*   1 if the sampling period changed, 0 otherwise
+*
+*****************************************************************************/
+int pipeline_step(pipeline_t *pipeline, measurement_t *measurement);
+
+#endif /* PIPELINE_H_ */
@@ -0,0 +1,104 @@
+/*****************************************************************************
+* Copyright (C) 2022 by Bhargav Dharmendra Chauhan
+*
+* Redistribution, modification or use of this software in source or binary
+* forms is permitted as long as the files maintain this copyright. Users are
+* permitted to modify this and use it to learn about the field of embedded
+* software. Bhargav Dharmendra Chauhan and the University of Colorado
+* are not liable for any misuse of this material.
+*
+*****************************************************************************/
+/*****************************************************************************
+*
+*    File name   : sample_bus.c
+*    Description : distributes every measurement to several consumers
+*                  (logging, telemetry, feedback) at their own rates
+*
+*    Author: Bhargav Dharmendra Chauhan
+*    Tools : MCUXpresso
+*    Date  : 10/19/2026
+*
+*****************************************************************************/
+
+// including required libraries
+#include <stdint.h>
+#include <stddef.h>
+#include "sample_bus.h"
+
+#define RING_MASK 			(SAMPLE_BUS_RING_SIZE - 1)
+
+// one entry of the subscriber table
+typedef struct
+{
+	sample_handler_t handler;
+	void *context;
+	uint16_t decimation;
+	uint16_t countdown;			// measurements left before the next delivery
+} subscriber_t;
+
+static subscriber_t subscribers[SAMPLE_BUS_MAX_SUBSCRIBERS];
+static uint8_t subscriber_count = 0;
+
+// shared ring, the slot of a sequence number is sequence & RING_MASK
+static measurement_t ring[SAMPLE_BUS_RING_SIZE];
+static uint32_t published = 0;
+
+// function definition in header file
+int sample_bus_subscribe(sample_handler_t handler, void *context, uint16_t decimation)
+{
+	subscriber_t *subscriber;
+
+	if (subscriber_count == SAMPLE_BUS_MAX_SUBSCRIBERS)
+		return -1;
+
+	subscriber = &subscribers[subscriber_count];
+	subscriber->handler = handler;
+	subscriber->context = context;
+	subscriber->decimation = decimation ? decimation : 1;
+	subscriber->countdown = 1;		// the first measurement is delivered
+	return subscriber_count++;
+}
+
+// function definition in header file
+void sample_bus_set_decimation(int id, uint16_t decimation)
+{
+	subscriber_t *subscriber = &subscribers[id];
+
+	subscriber->decimation = decimation ? decimation : 1;
+	if (subscriber->countdown > subscriber->decimation)
+		subscriber->countdown = subscriber->decimation;
+}
+
+// function definition in header file
+measurement_t *sample_bus_claim(void)
+{
+	return &ring[(published + 1) & RING_MASK];
+}
+
+// function definition in header file
+void sample_bus_publish(void)
+{
+	measurement_t *measurement = &ring[(published + 1) & RING_MASK];
+
+	measurement->sequence = ++published;
+
+	// every subscriber sees the same slot
+	for (int i = 0; i < subscriber_count; i++) {
+		subscriber_t *subscriber = &subscribers[i];
+
+		if (--subscriber->countdown == 0) {
+			subscriber->countdown = subscriber->decimation;
+			subscriber->handler(measurement, subscriber->context);
+		}
+	}
+}
+
+// function definition in header file
+const measurement_t *sample_bus_get(uint32_t sequence)
+{
+	// the claimed slot may already be partly overwritten, it is excluded
+	if (sequence == 0 || sequence > published
+			|| published - sequence >= SAMPLE_BUS_RING_SIZE - 1)
+		return NULL;
+	return &ring[sequence & RING_MASK];
+}
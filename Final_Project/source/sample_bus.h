@@ -0,0 +1,100 @@
+/*****************************************************************************
+* Copyright (C) 2022 by Bhargav Dharmendra Chauhan
+*
+* Redistribution, modification or use of this software in source or binary
+* forms is permitted as long as the files maintain this copyright. Users are
+* permitted to modify this and use it to learn about the field of embedded
+* software. Bhargav Dharmendra Chauhan and the University of Colorado
+* are not liable for any misuse of this material.
+*
+*****************************************************************************/
+/*****************************************************************************
+*
+*    File name   : sample_bus.h
+*    Description : distributes every measurement to several consumers
+*                  (logging, telemetry, feedback) at their own rates
+*
+*    Author: Bhargav Dharmendra Chauhan
+*    Tools : MCUXpresso
+*    Date  : 10/19/2026
+*
+*    The producer fills a slot of a shared ring in place, claimed with
+*    sample_bus_claim(), and publishes it. Subscribers receive a pointer to
+*    the slot, nothing is copied. A pointer stays valid for the next
+*    SAMPLE_BUS_RING_SIZE - 1 publications, so a consumer may also keep it
+*    and use it later. Subscribers run in the context of the publisher.
+*
+*****************************************************************************/
+
+#ifndef SAMPLE_BUS_H_
+#define SAMPLE_BUS_H_
+
+#include <stdint.h>
+#include "accelerometer.h"
+
+#define SAMPLE_BUS_RING_SIZE 		(8)		// power of two
+#define SAMPLE_BUS_MAX_SUBSCRIBERS 	(6)
+
+// one published measurement
+typedef struct
+{
+	uint32_t sequence;			// publication number, from 1
+	sample_t sample;			// acquired sample
+	angle_t roll;				// estimated roll, relative to the reference
+	angle_t pitch;				// estimated pitch
+	uint8_t on_target;			// 1 when the roll is within the target window
+} measurement_t;
+
+// receives a measurement, the pointer stays valid for a few publications
+typedef void (*sample_handler_t)(const measurement_t *measurement, void *context);
+
+/*****************************************************************************
+* Adds a consumer to the subscriber table
+*
+* Parameters:
+*   handler			called with the measurements
+*   context			passed back to the handler
+*   decimation		receives one measurement out of this many, at least 1
+*
+* Returns:
+*   subscriber id, -1 if the table is full
+*
+*****************************************************************************/
+int sample_bus_subscribe(sample_handler_t handler, void *context, uint16_t decimation);
+
+/*****************************************************************************
+* Changes the rate of a subscriber, e.g. when the acquisition rate changes
+*
+* Parameters:
+*   id				id returned by sample_bus_subscribe()
+*   decimation		receives one measurement out of this many, at least 1
+*
+*****************************************************************************/
+void sample_bus_set_decimation(int id, uint16_t decimation);
+
+/*****************************************************************************
+* Returns the ring slot of the next measurement, to be filled in place and
+* then published with sample_bus_publish()
+*
+*****************************************************************************/
+measurement_t *sample_bus_claim(void);
+
+/*****************************************************************************
+* Publishes the claimed slot and calls the subscribers that are due
+*
+*****************************************************************************/
+void sample_bus_publish(void);
+
+/*****************************************************************************
+* Returns a recent measurement by sequence number
+*
+* Parameters:
+*   sequence		sequence number of the measurement
+*
+* Returns:
+*   the measurement, NULL if it is not published or already overwritten
+*
+*****************************************************************************/
+const measurement_t *sample_bus_get(uint32_t sequence);
+
+#endif /* SAMPLE_BUS_H_ */
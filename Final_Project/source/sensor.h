@@ -0,0 +1,63 @@
+/*****************************************************************************
+* Copyright (C) 2022 by Bhargav Dharmendra Chauhan
+*
+* Redistribution, modification or use of this software in source or binary
+* forms is permitted as long as the files maintain this copyright. Users are
+* permitted to modify this and use it to learn about the field of embedded
+* software. Bhargav Dharmendra Chauhan and the University of Colorado
+* are not liable for any misuse of this material.
+*
+*****************************************************************************/
+/*****************************************************************************
+*
+*    File name   : sensor.h
+*    Description : accelerometer driver interface, the acquisition code
+*                  only talks to the sensor through it
+*
+*    Author: Bhargav Dharmendra Chauhan
+*    Tools : MCUXpresso
+*    Date  : 10/19/2026
+*
+*    The MMA8451 driver (mma8451.c) is the one used on target. Drivers
+*    without hardware access, like the one in host/, feed synthetic or
+*    recorded samples to the same filter, angle and decision code.
+*
+*****************************************************************************/
+
+#ifndef SENSOR_H_
+#define SENSOR_H_
+
+#include <stdint.h>
+#include "i2c.h"
+#include "tilt.h"
+
+// leaves a sensor_config_t setting as it is
+#define SENSOR_KEEP 		(0xFF)
+
+// acquisition settings, drivers pick the closest mode they support
+typedef struct
+{
+	uint32_t period_us;			// wanted sample period
+	uint8_t oversampling;		// driver specific oversampling mode, or SENSOR_KEEP
+	uint8_t low_noise;			// low noise front end if supported, or SENSOR_KEEP
+} sensor_config_t;
+
+// operations of one accelerometer driver
+typedef struct
+{
+	const char *name;
+
+	// prepares the sensor, returns I2C_OK on success
+	i2c_status_t (*init)(void);
+
+	// reads one raw X, Y and Z sample in a single burst
+	i2c_status_t (*read_burst)(int16_t xyz[AXIS_COUNT]);
+
+	// applies acquisition settings
+	i2c_status_t (*configure)(const sensor_config_t *config);
+
+	// time base of the samples, in microseconds
+	uint64_t (*get_timestamp_us)(void);
+} sensor_driver_t;
+
+#endif /* SENSOR_H_ */
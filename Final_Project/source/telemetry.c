@@ -0,0 +1,164 @@
+/*****************************************************************************
+* Copyright (C) 2022 by Bhargav Dharmendra Chauhan
+*
+* Redistribution, modification or use of this software in source or binary
+* forms is permitted as long as the files maintain this copyright. Users are
+* permitted to modify this and use it to learn about the field of embedded
+* software. Bhargav Dharmendra Chauhan and the University of Colorado
+* are not liable for any misuse of this material.
+*
+*****************************************************************************/
+/*****************************************************************************
+*
+*    File name   : telemetry.c
+*    Description : binary telemetry records, framed with COBS and checked
+*                  with a CRC-16
+*
+*    Author: Bhargav Dharmendra Chauhan
+*    Tools : MCUXpresso
+*    Date  : 10/19/2026
+*
+*    References: Cheshire and Baker, Consistent Overhead Byte Stuffing,
+*                IEEE/ACM Transactions on Networking, 1999
+*
+*****************************************************************************/
+
+// including required libraries
+#include <stdint.h>
+#include <stddef.h>
+#include "telemetry.h"
+
+#define BYTE_MASK 			(0xFF)
+#define BYTE_BITS 			(8)
+#define CRC_INITIAL 		(0xFFFF)
+#define CRC_POLYNOMIAL 		(0x1021)
+#define CRC_TOP_BIT 		(0x8000)
+#define COBS_MAX_CODE 		(0xFF)		// 254 data bytes without a zero
+#define PAYLOAD_BYTES 		(TELEMETRY_RECORD_BYTES + TELEMETRY_CRC_BYTES)
+
+// record field offsets
+#define OFFSET_SEQUENCE 	(0)
+#define OFFSET_TIMESTAMP 	(2)
+#define OFFSET_XYZ 			(6)
+#define OFFSET_ROLL 		(12)
+#define OFFSET_PITCH 		(16)
+#define OFFSET_FLAGS 		(18)
+
+// little endian helpers
+static void put_le(uint8_t *out, uint32_t value, int bytes)
+{
+	for (int i = 0; i < bytes; i++, value >>= BYTE_BITS)
+		out[i] = value & BYTE_MASK;
+}
+
+static uint32_t get_le(const uint8_t *in, int bytes)
+{
+	uint32_t value = 0;
+
+	for (int i = bytes - 1; i >= 0; i--)
+		value = (value << BYTE_BITS) | in[i];
+	return value;
+}
+
+// CRC-16/CCITT, bitwise, the records are short
+static uint16_t crc16(const uint8_t *data, size_t length)
+{
+	uint16_t crc = CRC_INITIAL;
+
+	for (size_t i = 0; i < length; i++) {
+		crc ^= (uint16_t)data[i] << BYTE_BITS;
+		for (int bit = 0; bit < BYTE_BITS; bit++)
+			crc = (crc & CRC_TOP_BIT) ? (crc << 1) ^ CRC_POLYNOMIAL : crc << 1;
+	}
+	return crc;
+}
+
+// replaces every zero by the distance to the next one, returns the length
+static size_t cobs_encode(const uint8_t *in, size_t length, uint8_t *out)
+{
+	size_t code_index = 0, out_index = 1;
+	uint8_t code = 1;
+
+	for (size_t i = 0; i < length; i++) {
+		if (in[i] != 0) {
+			out[out_index++] = in[i];
+			code++;
+		}
+		// a zero, or a run too long for one code byte, closes the block
+		if (in[i] == 0 || code == COBS_MAX_CODE) {
+			out[code_index] = code;
+			code_index = out_index++;
+			code = 1;
+		}
+	}
+	out[code_index] = code;
+	return out_index;
+}
+
+// reverse of cobs_encode, returns the length, 0 if the input is malformed
+static size_t cobs_decode(const uint8_t *in, size_t length, uint8_t *out, size_t capacity)
+{
+	size_t in_index = 0, out_index = 0;
+	uint8_t code;
+
+	while (in_index < length) {
+		code = in[in_index++];
+		if (code == 0 || in_index + code - 1 > length || out_index + code > capacity + 1)
+			return 0;
+		for (int i = 1; i < code; i++) {
+			if (in[in_index] == 0)
+				return 0;
+			out[out_index++] = in[in_index++];
+		}
+		// the implicit zero of a block, except after a full run and at the end
+		if (code != COBS_MAX_CODE && in_index < length) {
+			if (out_index == capacity)
+				return 0;
+			out[out_index++] = 0;
+		}
+	}
+	return out_index;
+}
+
+// function definition in header file
+size_t telemetry_encode(const telemetry_record_t *record,
+		uint8_t frame[TELEMETRY_FRAME_BYTES])
+{
+	uint8_t payload[PAYLOAD_BYTES];
+	size_t length;
+
+	put_le(&payload[OFFSET_SEQUENCE], record->sequence, 2);
+	put_le(&payload[OFFSET_TIMESTAMP], record->timestamp_us, 4);
+	for (int axis = 0; axis < AXIS_COUNT; axis++)
+		put_le(&payload[OFFSET_XYZ + 2 * axis], (uint16_t)record->xyz[axis], 2);
+	put_le(&payload[OFFSET_ROLL], (uint32_t)record->roll, 4);
+	put_le(&payload[OFFSET_PITCH], (uint16_t)record->pitch, 2);
+	payload[OFFSET_FLAGS] = record->flags;
+	put_le(&payload[TELEMETRY_RECORD_BYTES], crc16(payload, TELEMETRY_RECORD_BYTES),
+			TELEMETRY_CRC_BYTES);
+
+	length = cobs_encode(payload, PAYLOAD_BYTES, frame);
+	frame[length++] = 0;
+	return length;
+}
+
+// function definition in header file
+int telemetry_decode(const uint8_t *frame, size_t length, telemetry_record_t *record)
+{
+	uint8_t payload[PAYLOAD_BYTES];
+
+	if (cobs_decode(frame, length, payload, PAYLOAD_BYTES) != PAYLOAD_BYTES)
+		return 0;
+	if (get_le(&payload[TELEMETRY_RECORD_BYTES], TELEMETRY_CRC_BYTES)
+			!= crc16(payload, TELEMETRY_RECORD_BYTES))
+		return 0;
+
+	record->sequence = (uint16_t)get_le(&payload[OFFSET_SEQUENCE], 2);
+	record->timestamp_us = get_le(&payload[OFFSET_TIMESTAMP], 4);
+	for (int axis = 0; axis < AXIS_COUNT; axis++)
+		record->xyz[axis] = (int16_t)get_le(&payload[OFFSET_XYZ + 2 * axis], 2);
+	record->roll = (angle_t)get_le(&payload[OFFSET_ROLL], 4);
+	record->pitch = (int16_t)get_le(&payload[OFFSET_PITCH], 2);
+	record->flags = payload[OFFSET_FLAGS];
+	return 1;
+}
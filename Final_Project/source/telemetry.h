@@ -0,0 +1,92 @@
+/*****************************************************************************
+* Copyright (C) 2022 by Bhargav Dharmendra Chauhan
+*
+* Redistribution, modification or use of this software in source or binary
+* forms is permitted as long as the files maintain this copyright. Users are
+* permitted to modify this and use it to learn about the field of embedded
+* software. Bhargav Dharmendra Chauhan and the University of Colorado
+* are not liable for any misuse of this material.
+*
+*****************************************************************************/
+/*****************************************************************************
+*
+*    File name   : telemetry.h
+*    Description : binary telemetry records, framed with COBS and checked
+*                  with a CRC-16
+*
+*    Author: Bhargav Dharmendra Chauhan
+*    Tools : MCUXpresso
+*    Date  : 10/19/2026
+*
+*    Record, all fields little endian, TELEMETRY_RECORD_BYTES:
+*      uint16 sequence, uint32 timestamp in us (low 32 bits),
+*      int16 x, y, z counts before the filters, int32 roll, int16 pitch
+*      in centi-degrees, uint8 flags
+*
+*    Frame: the record followed by its CRC-16/CCITT (polynomial 0x1021,
+*    initial value 0xFFFF, little endian), COBS encoded so it holds no zero
+*    byte, then a zero delimiter. A receiver resynchronizes on the next
+*    zero after a corrupted frame, gaps in the sequence are lost frames.
+*
+*    No hardware is accessed here, the host decoder in host/ uses the
+*    same code.
+*
+*****************************************************************************/
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "tilt.h"
+
+#define TELEMETRY_RECORD_BYTES 	(19)
+#define TELEMETRY_CRC_BYTES 	(2)
+// record and crc, one COBS code byte, the delimiter
+#define TELEMETRY_FRAME_BYTES 	(TELEMETRY_RECORD_BYTES + TELEMETRY_CRC_BYTES + 2)
+
+// flags
+#define TELEMETRY_ON_TARGET 	(0x01)		// roll within the target window
+#define TELEMETRY_RANGE_MASK 	(0x06)		// sensor full scale range, mma_range_t
+#define TELEMETRY_RANGE_SHIFT 	(1)
+
+// content of one record
+typedef struct
+{
+	uint16_t sequence;
+	uint32_t timestamp_us;
+	int16_t xyz[AXIS_COUNT];	// calibrated counts, not filtered
+	angle_t roll;				// relative to the reference
+	angle_t pitch;
+	uint8_t flags;
+} telemetry_record_t;
+
+/*****************************************************************************
+* Encodes a record as a complete frame, delimiter included
+*
+* Parameters:
+*   record			record to send
+*   frame			TELEMETRY_FRAME_BYTES output bytes
+*
+* Returns:
+*   number of bytes of the frame
+*
+*****************************************************************************/
+size_t telemetry_encode(const telemetry_record_t *record,
+		uint8_t frame[TELEMETRY_FRAME_BYTES]);
+
+/*****************************************************************************
+* Decodes a frame received up to, not including, its delimiter
+*
+* Parameters:
+*   frame			received bytes
+*   length			number of bytes
+*   record			filled by the function
+*
+* Returns:
+*   1 if the frame is valid, 0 if it is malformed or fails the CRC
+*
+*****************************************************************************/
+int telemetry_decode(const uint8_t *frame, size_t length, telemetry_record_t *record);
+
+#endif /* TELEMETRY_H_ */
@@ -0,0 +1,50 @@
+/*****************************************************************************
+* Copyright (C) 2022 by Bhargav Dharmendra Chauhan
+*
+* Redistribution, modification or use of this software in source or binary
+* forms is permitted as long as the files maintain this copyright. Users are
+* permitted to modify this and use it to learn about the field of embedded
+* software. Bhargav Dharmendra Chauhan and the University of Colorado
+* are not liable for any misuse of this material.
+*
+*****************************************************************************/
+/*****************************************************************************
+*
+*    File name   : tilt.c
+*    Description : angle types and the tilt calculation of one sample,
+*                  free of hardware access so it also builds on a host
+*
+*    Author: Bhargav Dharmendra Chauhan
+*    Tools : MCUXpresso
+*    Date  : 10/19/2026
+*
+*****************************************************************************/
+
+// including required libraries
+#include <stdint.h>
+#include "tilt.h"
+#include "fp_math.h"
+
+#define MILLI_G (1000)
+#define COUNTS_PER_G_SHIFT (12)		// log2(COUNTS_PER_G)
+
+// function definition in header file
+void compute_tilt(const int16_t xyz[AXIS_COUNT], tilt_t *tilt)
+{
+	int32_t x = xyz[AXIS_X], y = xyz[AXIS_Y], z = xyz[AXIS_Z];
+	// squares are shared by the pitch and magnitude calculation
+	uint32_t yz_squared = (uint32_t)(y * y) + (uint32_t)(z * z);
+	uint32_t xyz_squared = yz_squared + (uint32_t)(x * x);
+
+	tilt->roll = fp_atan2(y, z);
+	tilt->pitch = fp_atan2(-x, fp_isqrt(yz_squared));
+
+	// counts to milli-g, COUNTS_PER_G is a power of two
+	tilt->magnitude_mg = (fp_isqrt(xyz_squared) * MILLI_G) >> COUNTS_PER_G_SHIFT;
+}
+
+// function definition in header file
+int target_reached(angle_t angle, angle_t target, angle_t tolerance)
+{
+	return angle >= target - tolerance && angle <= target + tolerance;
+}
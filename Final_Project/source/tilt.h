@@ -0,0 +1,79 @@
+/*****************************************************************************
+* Copyright (C) 2022 by Bhargav Dharmendra Chauhan
+*
+* Redistribution, modification or use of this software in source or binary
+* forms is permitted as long as the files maintain this copyright. Users are
+* permitted to modify this and use it to learn about the field of embedded
+* software. Bhargav Dharmendra Chauhan and the University of Colorado
+* are not liable for any misuse of this material.
+*
+*****************************************************************************/
+/*****************************************************************************
+*
+*    File name   : tilt.h
+*    Description : angle types and the tilt calculation of one sample,
+*                  free of hardware access so it also builds on a host
+*
+*    Author: Bhargav Dharmendra Chauhan
+*    Tools : MCUXpresso
+*    Date  : 10/19/2026
+*
+*****************************************************************************/
+
+#ifndef TILT_H_
+#define TILT_H_
+
+#include <stdint.h>
+
+// angles are carried through the pipeline in centi-degrees
+typedef int32_t angle_t;
+
+// integer only printf helpers for angle_t, e.g. printf(ANGLE_FMT, ANGLE_ARGS(a))
+#define ANGLE_FMT 			"%s%d.%02d"
+#define ANGLE_ARGS(angle) 	((angle) < 0 ? "-" : ""), \
+							(int)(((angle) < 0 ? -(angle) : (angle)) / 100), \
+							(int)(((angle) < 0 ? -(angle) : (angle)) % 100)
+
+// sensor scale in the default +/-2g, 14 bit mode
+#define COUNTS_PER_G 		(4096)
+
+// indices of the axes in a sample array
+#define AXIS_X 				(0)
+#define AXIS_Y 				(1)
+#define AXIS_Z 				(2)
+#define AXIS_COUNT 			(3)
+
+// tilt of the board computed from one sample
+typedef struct
+{
+	angle_t roll;			// rotation about X, atan2(y, z)
+	angle_t pitch;			// rotation about Y, atan2(-x, sqrt(y^2 + z^2))
+	uint32_t magnitude_mg;	// total acceleration in milli-g
+} tilt_t;
+
+/*****************************************************************************
+ * Computes roll, pitch and total acceleration from one sample using
+ * integer math only
+ *
+ * Parameters:
+ *   xyz      	array of AXIS_COUNT 14 bit samples
+ *   tilt		computed tilt of the board
+ *
+ *****************************************************************************/
+void compute_tilt(const int16_t xyz[AXIS_COUNT], tilt_t *tilt);
+
+/*****************************************************************************
+ * Decides whether an angle is inside the window around a target
+ *
+ * Parameters:
+ *   angle		measured angle
+ *   target		target angle
+ *   tolerance	half width of the window
+ *
+ * Returns:
+ *   1 if the target is reached, 0 otherwise
+ *
+ *****************************************************************************/
+int target_reached(angle_t angle, angle_t target, angle_t tolerance);
+
+#endif /* TILT_H_ */
@@ -0,0 +1,87 @@
+/*****************************************************************************
+* Copyright (C) 2022 by Bhargav Dharmendra Chauhan
+*
+* Redistribution, modification or use of this software in source or binary
+* forms is permitted as long as the files maintain this copyright. Users are
+* permitted to modify this and use it to learn about the field of embedded
+* software. Bhargav Dharmendra Chauhan and the University of Colorado
+* are not liable for any misuse of this material.
+*
+*****************************************************************************/
+/*****************************************************************************
+*
+*    File name   : timebase.c
+*    Description : free running microsecond time base built on the low
+*                  power timer, extended to 64 bits
+*
+*    Author: Bhargav Dharmendra Chauhan
+*    Tools : MCUXpresso
+*    Date  : 10/19/2026
+*
+*    References: KL25 Sub-Family Reference Manual, chapter 33 (LPTMR)
+*
+*****************************************************************************/
+
+// including required libraries
+#include "MKL25Z4.h"
+#include "timebase.h"
+
+#define COUNTER_BITS 			(16)
+#define COUNTER_TOP 			(0xFFFF)	// compare at the top, flag set on wrap
+#define COUNTER_HALF 			(0x8000)
+#define PRESCALE_DIV_4 			(1)			// 4 MHz / 4 = 1 MHz
+#define CLOCK_MCGIRCLK 			(0)
+
+// number of 16 bit wraps since timebase_init()
+static volatile uint32_t wraps = 0;
+
+// function definition in header file
+void timebase_init(void)
+{
+	SIM->SCGC5 |= SIM_SCGC5_LPTMR_MASK;
+
+	// MCGIRCLK from the fast 4 MHz IRC, the FLL keeps using the slow IRC
+	MCG->SC &= ~MCG_SC_FCRDIV_MASK;
+	MCG->C2 |= MCG_C2_IRCS_MASK;
+	MCG->C1 |= MCG_C1_IRCLKEN_MASK;
+
+	LPTMR0->CSR = 0;
+	LPTMR0->PSR = LPTMR_PSR_PCS(CLOCK_MCGIRCLK) | LPTMR_PSR_PRESCALE(PRESCALE_DIV_4);
+	LPTMR0->CMR = COUNTER_TOP;
+	wraps = 0;
+
+	// free running counter, interrupt when it rolls over
+	NVIC_ClearPendingIRQ(LPTMR0_IRQn);
+	NVIC_EnableIRQ(LPTMR0_IRQn);
+	LPTMR0->CSR = LPTMR_CSR_TFC_MASK | LPTMR_CSR_TIE_MASK | LPTMR_CSR_TEN_MASK;
+}
+
+// function definition in header file
+uint64_t timebase_now_us(void)
+{
+	uint32_t masking_state = __get_PRIMASK();
+	uint32_t count, high;
+
+	__disable_irq();
+
+	// any write to CNR latches the counter for reading
+	LPTMR0->CNR = 0;
+	count = LPTMR0->CNR;
+	high = wraps;
+
+	// a wrap not yet seen by the interrupt, the count has already restarted
+	if ((LPTMR0->CSR & LPTMR_CSR_TCF_MASK) && count < COUNTER_HALF)
+		high++;
+
+	__set_PRIMASK(masking_state);
+
+	return ((uint64_t)high << COUNTER_BITS) | count;
+}
+
+// function definition in header file
+void LPTMR0_IRQHandler(void)
+{
+	// the flag is write one to clear, the other bits are written back
+	LPTMR0->CSR |= LPTMR_CSR_TCF_MASK;
+	wraps++;
+}
@@ -0,0 +1,51 @@
+/*****************************************************************************
+* Copyright (C) 2022 by Bhargav Dharmendra Chauhan
+*
+* Redistribution, modification or use of this software in source or binary
+* forms is permitted as long as the files maintain this copyright. Users are
+* permitted to modify this and use it to learn about the field of embedded
+* software. Bhargav Dharmendra Chauhan and the University of Colorado
+* are not liable for any misuse of this material.
+*
+*****************************************************************************/
+/*****************************************************************************
+*
+*    File name   : timebase.h
+*    Description : free running microsecond time base built on the low
+*                  power timer, extended to 64 bits
+*
+*    Author: Bhargav Dharmendra Chauhan
+*    Tools : MCUXpresso
+*    Date  : 10/19/2026
+*
+*    Unlike the SysTick cycle counter this keeps counting while the core
+*    sleeps and never wraps, it is meant for long intervals and timestamps.
+*
+*****************************************************************************/
+
+#ifndef TIMEBASE_H_
+#define TIMEBASE_H_
+
+#include <stdint.h>
+
+/*****************************************************************************
+* Starts LPTMR0 at 1 MHz from the fast internal reference clock, with an
+* interrupt on every 16 bit wrap to extend the count
+*
+*****************************************************************************/
+void timebase_init(void);
+
+/*****************************************************************************
+* Returns the microseconds elapsed since timebase_init(), safe to call from
+* any context
+*
+*****************************************************************************/
+uint64_t timebase_now_us(void);
+
+/*****************************************************************************
+* Counts the wraps of the 16 bit counter
+*
+*****************************************************************************/
+void LPTMR0_IRQHandler(void);
+
+#endif /* TIMEBASE_H_ */
@@ -0,0 +1,225 @@
+/*****************************************************************************
+* Copyright (C) 2022 by Bhargav Dharmendra Chauhan
+*
+* Redistribution, modification or use of this software in source or binary
+* forms is permitted as long as the files maintain this copyright. Users are
+* permitted to modify this and use it to learn about the field of embedded
+* software. Bhargav Dharmendra Chauhan and the University of Colorado
+* are not liable for any misuse of this material.
+*
+*****************************************************************************/
+/*****************************************************************************
+*
+*    File name   : trace.c
+*    Description : capture of timestamped raw samples in a compact binary
+*                  format, and a sensor driver replaying such a trace
+*
+*    Author: Bhargav Dharmendra Chauhan
+*    Tools : MCUXpresso
+*    Date  : 10/19/2026
+*
+*****************************************************************************/
+
+// including required libraries
+#include <stdint.h>
+#include <stddef.h>
+#include "trace.h"
+
+#define BYTE_MASK 			(0xFF)
+#define BYTE_BITS 			(8)
+#define TIMESTAMP_BYTES 	(4)
+
+// state of the trace being replayed
+static trace_read_t replay_read = NULL;
+static trace_write_t replay_request = NULL;
+static uint32_t replay_block = 0;
+static trace_clock_t replay_clock = NULL;
+static uint64_t replay_start_clock;
+static uint64_t replay_timestamp;		// extended to 64 bits
+static uint64_t replay_first;
+static uint32_t replay_last_low;
+static uint8_t replay_primed;
+static uint8_t replay_done = 1;
+
+// little endian helpers
+static void put_le(uint8_t *out, uint32_t value, int bytes)
+{
+	for (int i = 0; i < bytes; i++, value >>= BYTE_BITS)
+		out[i] = value & BYTE_MASK;
+}
+
+static uint32_t get_le(const uint8_t *in, int bytes)
+{
+	uint32_t value = 0;
+
+	for (int i = bytes - 1; i >= 0; i--)
+		value = (value << BYTE_BITS) | in[i];
+	return value;
+}
+
+// function definition in header file
+void trace_encode(uint8_t record[TRACE_RECORD_BYTES], uint64_t timestamp_us,
+		const int16_t xyz[AXIS_COUNT])
+{
+	put_le(record, (uint32_t)timestamp_us, TIMESTAMP_BYTES);
+	for (int axis = 0; axis < AXIS_COUNT; axis++)
+		put_le(&record[TIMESTAMP_BYTES + 2 * axis], (uint16_t)xyz[axis], 2);
+}
+
+// function definition in header file
+void trace_decode(const uint8_t record[TRACE_RECORD_BYTES], uint32_t *timestamp_us,
+		int16_t xyz[AXIS_COUNT])
+{
+	*timestamp_us = get_le(record, TIMESTAMP_BYTES);
+	for (int axis = 0; axis < AXIS_COUNT; axis++)
+		xyz[axis] = (int16_t)get_le(&record[TIMESTAMP_BYTES + 2 * axis], 2);
+}
+
+// function definition in header file
+uint8_t trace_checksum(const uint8_t *data, size_t length)
+{
+	uint8_t sum = 0;
+
+	for (size_t i = 0; i < length; i++)
+		sum += data[i];
+	return (uint8_t)-sum;
+}
+
+// reads the next block of the trace, requesting it when pulled, returns 0
+// at the end of the trace
+static int read_block(uint8_t *block, size_t length)
+{
+	uint8_t request = (replay_block++ & 1) ? TRACE_REQUEST_ODD : TRACE_REQUEST_EVEN;
+	uint8_t check, discard;
+
+	if (!replay_request)
+		return replay_read(block, length) == length;
+
+	for (int attempt = 0; attempt < TRACE_RETRIES; attempt++) {
+		// a failed block: wait for the line to go quiet so the answer to
+		// the new request is not mixed with the remains of the old one
+		if (attempt > 0)
+			while (replay_read(&discard, 1) == 1)
+				;
+
+		replay_request(&request, 1);
+		if (replay_read(block, length) == length && replay_read(&check, 1) == 1
+				&& check == trace_checksum(block, length))
+			return 1;
+	}
+	return 0;
+}
+
+// function definition in header file
+i2c_status_t trace_capture(const sensor_driver_t *driver, uint32_t period_us,
+		uint32_t samples, trace_write_t write)
+{
+	uint8_t header[TRACE_HEADER_BYTES];
+	uint8_t record[TRACE_RECORD_BYTES];
+	int16_t xyz[AXIS_COUNT];
+	uint64_t next = driver->get_timestamp_us();
+	i2c_status_t status;
+
+	put_le(header, TRACE_MAGIC, TIMESTAMP_BYTES);
+	put_le(&header[TIMESTAMP_BYTES], period_us, TIMESTAMP_BYTES);
+	write(header, sizeof(header));
+
+	for (uint32_t i = 0; samples == 0 || i < samples; i++) {
+		// fixed period, a late sample does not shift the following ones
+		while (driver->get_timestamp_us() < next)
+			;
+		next += period_us;
+
+		status = driver->read_burst(xyz);
+		if (status != I2C_OK)
+			return status;
+		trace_encode(record, driver->get_timestamp_us(), xyz);
+		write(record, sizeof(record));
+	}
+	return I2C_OK;
+}
+
+// function definition in header file
+uint32_t trace_replay_start(trace_read_t read, trace_write_t request, trace_clock_t clock)
+{
+	uint8_t header[TRACE_HEADER_BYTES];
+
+	replay_done = 1;
+	replay_read = read;
+	replay_request = request;
+	replay_block = 0;
+	if (!read_block(header, sizeof(header))
+			|| get_le(header, TIMESTAMP_BYTES) != TRACE_MAGIC)
+		return 0;
+
+	replay_clock = clock;
+	replay_timestamp = 0;
+	replay_primed = 0;
+	replay_done = 0;
+	return get_le(&header[TIMESTAMP_BYTES], TIMESTAMP_BYTES);
+}
+
+// function definition in header file
+int trace_replay_done(void)
+{
+	return replay_done;
+}
+
+// sensor interface: the trace is opened by trace_replay_start()
+static i2c_status_t replay_init(void)
+{
+	return replay_done ? I2C_ERR_NACK : I2C_OK;
+}
+
+// sensor interface: next record, paced on the recorded timestamps
+static i2c_status_t replay_read_burst(int16_t xyz[AXIS_COUNT])
+{
+	uint8_t record[TRACE_RECORD_BYTES];
+	uint32_t low;
+
+	// the end of the trace looks like a sensor that stopped answering
+	if (replay_done || !read_block(record, sizeof(record))) {
+		replay_done = 1;
+		return I2C_ERR_TIMEOUT;
+	}
+	trace_decode(record, &low, xyz);
+
+	// extend the 32 bit timestamps, they wrap after about 71 minutes
+	if (!replay_primed) {
+		replay_timestamp = low;
+		replay_first = low;
+		replay_primed = 1;
+		if (replay_clock)
+			replay_start_clock = replay_clock();
+	} else {
+		replay_timestamp += (uint32_t)(low - replay_last_low);
+	}
+	replay_last_low = low;
+
+	// recorded speed, wait until as much time passed as in the trace
+	if (replay_clock)
+		while (replay_clock() - replay_start_clock < replay_timestamp - replay_first)
+			;
+	return I2C_OK;
+}
+
+// sensor interface: nothing to configure, the rate is the recorded one
+static i2c_status_t replay_configure(const sensor_config_t *config)
+{
+	(void)config;
+	return I2C_OK;
+}
+
+// sensor interface: timestamp of the last record read
+static uint64_t replay_timestamp_us(void)
+{
+	return replay_timestamp;
+}
+
+const sensor_driver_t trace_sensor = {
+	"trace replay",
+	replay_init,
+	replay_read_burst,
+	replay_configure,
+	replay_timestamp_us,
+};
@@ -0,0 +1,145 @@
+/*****************************************************************************
+* Copyright (C) 2022 by Bhargav Dharmendra Chauhan
+*
+* Redistribution, modification or use of this software in source or binary
+* forms is permitted as long as the files maintain this copyright. Users are
+* permitted to modify this and use it to learn about the field of embedded
+* software. Bhargav Dharmendra Chauhan and the University of Colorado
+* are not liable for any misuse of this material.
+*
+*****************************************************************************/
+/*****************************************************************************
+*
+*    File name   : trace.h
+*    Description : capture of timestamped raw samples in a compact binary
+*                  format, and a sensor driver replaying such a trace
+*
+*    Author: Bhargav Dharmendra Chauhan
+*    Tools : MCUXpresso
+*    Date  : 10/19/2026
+*
+*    Trace format, all fields little endian:
+*      header   "ATR1", uint32 nominal sample period in us
+*      records  uint32 timestamp in us (low 32 bits), int16 x, y, z raw
+*               counts, TRACE_RECORD_BYTES each, until the end of the stream
+*
+*    No hardware is accessed here, the bytes go through the write and read
+*    functions given by the caller, so the same code captures and replays
+*    on target (UART) and on a host (files).
+*
+*    Replay over a serial link pulls the trace from the sender (host/
+*    trace_send.c) one block at a time, so the receive buffer can never
+*    overflow and the sender is paced by the replay:
+*      the replay requests block n, the header first and then one record
+*      per block, with TRACE_REQUEST_EVEN or TRACE_REQUEST_ODD after the
+*      parity of n. The sender answers with the block followed by its
+*      trace_checksum(), it moves to the next block when the parity
+*      changes and sends the same block again otherwise, so a lost
+*      request or answer never skips or repeats a record.
+*      A block that is short or fails the checksum is requested again
+*      after the line went quiet, the end of the trace is a sender that
+*      stops answering.
+*    The requests are control characters that never appear in the text
+*    output, the replay cannot be combined with the binary TELEMETRY
+*    stream on the same uart.
+*
+*****************************************************************************/
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "sensor.h"
+
+#define TRACE_MAGIC 			(0x31525441)	// "ATR1" read as little endian
+#define TRACE_HEADER_BYTES 		(8)
+#define TRACE_RECORD_BYTES 		(10)
+#define TRACE_REQUEST_EVEN 		(0x05)			// ENQ, requests an even block
+#define TRACE_REQUEST_ODD 		(0x06)			// ACK, requests an odd block
+#define TRACE_RETRIES 			(3)				// requests per block before the end
+
+// moves bytes to or from the trace stream, returns the number moved, a
+// read over a link returns fewer bytes when nothing came within its timeout
+typedef size_t (*trace_write_t)(const uint8_t *data, size_t length);
+typedef size_t (*trace_read_t)(uint8_t *data, size_t length);
+
+// microsecond clock pacing the replay, NULL replays at maximum speed
+typedef uint64_t (*trace_clock_t)(void);
+
+// driver returning the samples of the trace opened by trace_replay_start()
+extern const sensor_driver_t trace_sensor;
+
+/*****************************************************************************
+* Encodes one sample as a trace record
+*
+* Parameters:
+*   record			TRACE_RECORD_BYTES output bytes
+*   timestamp_us	time of the sample
+*   xyz				raw sample
+*
+*****************************************************************************/
+void trace_encode(uint8_t record[TRACE_RECORD_BYTES], uint64_t timestamp_us,
+		const int16_t xyz[AXIS_COUNT]);
+
+/*****************************************************************************
+* Decodes one trace record
+*
+* Parameters:
+*   record			TRACE_RECORD_BYTES input bytes
+*   timestamp_us	low 32 bits of the sample time
+*   xyz				raw sample
+*
+*****************************************************************************/
+void trace_decode(const uint8_t record[TRACE_RECORD_BYTES], uint32_t *timestamp_us,
+		int16_t xyz[AXIS_COUNT]);
+
+/*****************************************************************************
+* Checksum sent after every block of a pulled replay, the two's complement
+* of the 8 bit sum of the bytes
+*
+* Parameters:
+*   data			block bytes
+*   length			number of bytes
+*
+*****************************************************************************/
+uint8_t trace_checksum(const uint8_t *data, size_t length);
+
+/*****************************************************************************
+* Reads samples from a driver at a fixed period and streams them as a trace
+*
+* Parameters:
+*   driver			sensor to record
+*   period_us		sample period, paced with the driver timestamps
+*   samples			number of samples, 0 to record until a read fails
+*   write			output of the trace bytes
+*
+* Returns:
+*   status of the read that ended the capture, I2C_OK if all were recorded
+*
+*****************************************************************************/
+i2c_status_t trace_capture(const sensor_driver_t *driver, uint32_t period_us,
+		uint32_t samples, trace_write_t write);
+
+/*****************************************************************************
+* Opens a trace for trace_sensor, reading and checking its header
+*
+* Parameters:
+*   read			input of the trace bytes
+*   request			output of the block requests to pull the trace from a
+*					sender, NULL to read a plain stream such as a file
+*   clock			replays at the recorded speed, NULL for maximum speed
+*
+* Returns:
+*   nominal sample period of the trace in us, 0 if the header is invalid
+*
+*****************************************************************************/
+uint32_t trace_replay_start(trace_read_t read, trace_write_t request, trace_clock_t clock);
+
+/*****************************************************************************
+* Returns 1 once trace_sensor has returned the last record of the trace
+*
+*****************************************************************************/
+int trace_replay_done(void);
+
+#endif /* TRACE_H_ */
@@ -25,8 +25,11 @@
 //including the required libraries
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 #include "MKL25Z4.h"
 #include "cbfifo.h"
+#include "timebase.h"
+#include "uart.h"
 
 //defining the macros for different constant data
 #define UART_OVERSAMPLE_RATE (16)	// defining the oversample rate
@@ -41,9 +44,39 @@
 #define MAX_DIGIT ('9')				// Max digit represented in char
 #define MIN_DIGIT ('0')				// Min digit represented in char
 #define DECIMAL_CONVERSION (10)		// multiplication factor to convert into decimal
+#define DECIMAL_POINT ('.')			// decimal point character
+#define CENTI_DIGITS (2)			// fractional digits kept by get_centi_input
+#define MAX_INPUT_DIGITS (7)		// digits accepted by get_centi_input
+#define RX_BUFFER_SIZE (1024)		// receive fifo capacity, a power of two, 266 ms at 38400
+#define TX_BUFFER_SIZE (256)		// transmit fifo capacity, a power of two
+#define TX_DMA_CHANNEL (1)			// channel 0 plays the audio
+#define TX_DMAMUX_SOURCE (3)		// UART0 transmit request
+#define DMA_SIZE_8BIT (1)			// SSIZE and DSIZE value of byte transfers
+#define RX_DMA_CHANNEL (2)
+#define RX_DMAMUX_SOURCE (2)		// UART0 receive request
+#define RX_DMA_DMOD (7)				// 1 KB circular destination, RX_BUFFER_SIZE
+#define RX_DMA_BYTES (0xFFFFF)		// longest transfer, rearmed when done
 
 //creating an instance of transmit and receive buffer
 cbfifo receive_cbfifo, transmit_cbfifo;
+// aligned on its size for the DMA destination modulo
+static uint8_t receive_storage[RX_BUFFER_SIZE] __attribute__((aligned(RX_BUFFER_SIZE)));
+static uint8_t transmit_storage[TX_BUFFER_SIZE];
+
+//transmit through DMA, and the bytes of the transfer in progress, 0 if idle
+static volatile uint8_t tx_dma_enabled = 0;
+static volatile size_t tx_dma_span = 0;
+
+//transmit policy and the output it discarded
+static volatile uart_tx_policy_t tx_policy = UART_TX_BLOCK;
+static volatile uint32_t tx_dropped = 0;
+
+//receive through DMA straight into the receive fifo storage, the bytes it
+//moved at the last rearm and up to the last sync, and the input it overran
+static volatile uint8_t rx_dma_enabled = 0;
+static volatile uint32_t rx_dma_rearmed = 0;
+static volatile uint32_t rx_dma_synced = 0;
+static volatile uint32_t rx_overruns = 0;
 
 //function definition in uart.h file
 void Init_Uart0(uint32_t baud_rate) {
@@ -92,8 +125,8 @@ void Init_Uart0(uint32_t baud_rate) {
 	UART0->S2 = UART0_S2_MSBF(0) | UART0_S2_RXINV(0);
 
 	//initializing the cbfifo for receive and transmit
-	cbfifo_init(&receive_cbfifo);
-	cbfifo_init(&transmit_cbfifo);
+	cbfifo_init(&receive_cbfifo, receive_storage, RX_BUFFER_SIZE);
+	cbfifo_init(&transmit_cbfifo, transmit_storage, TX_BUFFER_SIZE);
 
 	// Enable interrupts
 	NVIC_SetPriority(UART0_IRQn, 2); // 0, 1, 2, or 3
@@ -109,45 +142,93 @@ void Init_Uart0(uint32_t baud_rate) {
 
 }
 
+// bytes moved by the receive DMA since it was enabled, the transfer count
+// tells wraps of the storage apart, which the destination address can not
+static uint32_t rx_dma_total(void)
+{
+	return rx_dma_rearmed + RX_DMA_BYTES
+			- (DMA0->DMA[RX_DMA_CHANNEL].DSR_BCR & DMA_DSR_BCR_BCR_MASK);
+}
+
+// hands the bytes written by the receive DMA to the consumer, called from
+// the idle line and DMA interrupts and by the readers (reader set)
+static void rx_dma_sync(int reader)
+{
+	uint32_t interrupt_mask, written;
+
+	if (!rx_dma_enabled)
+		return;
+
+	// the interrupt handlers publish too, head must not move meanwhile
+	interrupt_mask = __get_PRIMASK();
+	__disable_irq();
+	written = rx_dma_total() - rx_dma_synced;
+	if (written <= RX_BUFFER_SIZE - cbfifo_length(&receive_cbfifo)) {
+		cbfifo_commit(&receive_cbfifo, written);
+		rx_dma_synced += written;
+	} else if (reader) {
+		// the DMA wrapped over unread bytes, which of them survived is
+		// unknown: drop all of them and restart at the DMA position. Only
+		// the reader moves the tail, an interrupt leaves this to it
+		rx_overruns++;
+		cbfifo_commit(&receive_cbfifo, written);
+		cbfifo_consume(&receive_cbfifo, cbfifo_length(&receive_cbfifo));
+		rx_dma_synced += written;
+	}
+	__set_PRIMASK(interrupt_mask);
+}
+
 //function definition in uart.h file
 void UART0_IRQHandler(void) {
 	//define a variable to store transmit and receive character
 	char character;
+	//span of the fifo, read and written in place
+	uint8_t *span;
+
+	//the line went idle after a DMA reception, flush the partial frame
+	if ((UART0->C2 & UART0_C2_ILIE_MASK) && (UART0->S1 & UART0_S1_IDLE_MASK)) {
+		UART0->S1 = UART0_S1_IDLE_MASK;
+		rx_dma_sync(0);
+	}
 
 	//check if any of the error flags are set
 	if (UART0->S1 & (UART_S1_OR_MASK | UART_S1_NF_MASK |
 	UART_S1_FE_MASK | UART_S1_PF_MASK)) {
-		//if any of the flag is set reset it by writing 1
-		UART0->S1 |= UART0_S1_OR_MASK | UART0_S1_NF_MASK |
+		//if any of the flag is set reset it by writing 1, the other
+		//flags are left alone
+		UART0->S1 = UART0_S1_OR_MASK | UART0_S1_NF_MASK |
 		UART0_S1_FE_MASK | UART0_S1_PF_MASK;
-		//read the data register to reset the RDRF flag
-		character = UART0->D;
+		//read the data register to reset the RDRF flag, with RDMAE set
+		//the byte belongs to the DMA, which reads it itself
+		if (!(UART0->C5 & UART0_C5_RDMAE_MASK))
+			character = UART0->D;
 	}
 	// check if character is received and caused interrupt
 	// this is done by checking thr receive data register flag
-	if (UART0->S1 & UART0_S1_RDRF_MASK) {
+	// with RDMAE set the DMA reads the data register instead
+	if (!(UART0->C5 & UART0_C5_RDMAE_MASK) && (UART0->S1 & UART0_S1_RDRF_MASK)) {
 		//store the recieved character to the variable
 		character = UART0->D;
 
-		//check if the receive fifo is full
-		if (!(cbfifo_length(&receive_cbfifo) == cbfifo_capacity(&receive_cbfifo))) {
-			//if not full enqueue the received character to the cbfifo
-			cbfifo_enqueue(&character, 1, &receive_cbfifo);
+		//if the receive fifo is not full store the character in place
+		if (cbfifo_reserve(&receive_cbfifo, &span)) {
+			*span = character;
+			cbfifo_commit(&receive_cbfifo, 1);
 		}
 		// else queue is full and the received character is discarded
-		else {
-
-		}
 	}
 
 	// enable the transmit interrupt and check if transmit buffer is empty
 	// isr is triggered for transmission for this condition
-	if ((UART0->C2 & UART0_C2_TIE_MASK) && (UART0->S1 & UART0_S1_TDRE_MASK)) {
+	// with TDMAE set the transmitter requests DMA instead
+	if ((UART0->C2 & UART0_C2_TIE_MASK) && !(UART0->C5 & UART0_C5_TDMAE_MASK)
+			&& (UART0->S1 & UART0_S1_TDRE_MASK)) {
 		// if the above condition is true, then character is ready to transmit
 		// check if the cbfifo is not empty
-		// then dequeue the character from the cbfifo and put into the data register
-		if (cbfifo_dequeue(&character, 1, &transmit_cbfifo) == 1) {
-			UART0->D = character;
+		// then send the oldest character from the cbfifo in place
+		if (cbfifo_peek(&transmit_cbfifo, &span)) {
+			UART0->D = *span;
+			cbfifo_consume(&transmit_cbfifo, 1);
 		}
 		// else disable the transmit interrupt
 		else {
@@ -156,27 +237,281 @@ void UART0_IRQHandler(void) {
 	}
 }
 
+// hands the oldest contiguous span of the transmit fifo to the DMA
+static void tx_dma_start(void)
+{
+	uint8_t *span;
+	size_t length = cbfifo_peek(&transmit_cbfifo, &span);
+
+	tx_dma_span = length;
+	if (length == 0)
+		return;
+
+	// clear DONE before the channel is programmed again
+	DMA0->DMA[TX_DMA_CHANNEL].DSR_BCR = DMA_DSR_BCR_DONE_MASK;
+	DMA0->DMA[TX_DMA_CHANNEL].SAR = DMA_SAR_SAR((uint32_t)span);
+	DMA0->DMA[TX_DMA_CHANNEL].DSR_BCR = DMA_DSR_BCR_BCR(length);
+	DMA0->DMA[TX_DMA_CHANNEL].DCR |= DMA_DCR_ERQ_MASK;
+}
+
+// starts sending newly queued data, an active transmission picks it up
+// by itself
+static void start_transmit(void)
+{
+	if (tx_dma_enabled)
+	{
+		// no transfer, hence no completion interrupt, can be pending here
+		if (tx_dma_span == 0)
+			tx_dma_start();
+	}
+	else if (!(UART0->C2 & UART0_C2_TIE_MASK))
+	{
+		UART0->C2 |= UART0_C2_TIE(1);
+	}
+}
+
+//function definition in uart.h file
+void DMA1_IRQHandler(void)
+{
+	// the span is sent, give it back to the producer and send the next
+	DMA0->DMA[TX_DMA_CHANNEL].DSR_BCR = DMA_DSR_BCR_DONE_MASK;
+	cbfifo_consume(&transmit_cbfifo, tx_dma_span);
+	tx_dma_start();
+}
+
+//function definition in uart.h file
+size_t uart_tx_pending(void)
+{
+	return cbfifo_length(&transmit_cbfifo);
+}
+
+//function definition in uart.h file
+void uart_tx_dma(int enable)
+{
+	// switch once the queued output is sent
+	uart_flush();
+
+	if (enable)
+	{
+		SIM->SCGC7 |= SIM_SCGC7_DMA_MASK;
+		SIM->SCGC6 |= SIM_SCGC6_DMAMUX_MASK;
+		DMAMUX0->CHCFG[TX_DMA_CHANNEL] = 0;
+
+		// bytes from the fifo to the data register, one per request, the
+		// request is disabled at the end of the span
+		DMA0->DMA[TX_DMA_CHANNEL].DCR = DMA_DCR_EINT_MASK | DMA_DCR_SINC_MASK
+				| DMA_DCR_SSIZE(DMA_SIZE_8BIT) | DMA_DCR_DSIZE(DMA_SIZE_8BIT)
+				| DMA_DCR_CS_MASK | DMA_DCR_D_REQ_MASK;
+		DMA0->DMA[TX_DMA_CHANNEL].DAR = DMA_DAR_DAR((uint32_t)&UART0->D);
+
+		NVIC_SetPriority(DMA1_IRQn, 2);
+		NVIC_ClearPendingIRQ(DMA1_IRQn);
+		NVIC_EnableIRQ(DMA1_IRQn);
+		DMAMUX0->CHCFG[TX_DMA_CHANNEL] = DMAMUX_CHCFG_SOURCE(TX_DMAMUX_SOURCE)
+				| DMAMUX_CHCFG_ENBL_MASK;
+
+		// TDRE raises a DMA request instead of an interrupt
+		UART0->C5 |= UART0_C5_TDMAE_MASK;
+		UART0->C2 |= UART0_C2_TIE(1);
+	}
+	else
+	{
+		UART0->C2 &= ~UART0_C2_TIE_MASK;
+		UART0->C5 &= ~UART0_C5_TDMAE_MASK;
+		DMAMUX0->CHCFG[TX_DMA_CHANNEL] = 0;
+		NVIC_DisableIRQ(DMA1_IRQn);
+	}
+	tx_dma_enabled = enable;
+}
+
+//function definition in uart.h file
+void DMA2_IRQHandler(void)
+{
+	// the transfer count ran out, the destination keeps wrapping
+	rx_dma_rearmed += RX_DMA_BYTES;
+	DMA0->DMA[RX_DMA_CHANNEL].DSR_BCR = DMA_DSR_BCR_DONE_MASK;
+	DMA0->DMA[RX_DMA_CHANNEL].DSR_BCR = DMA_DSR_BCR_BCR(RX_DMA_BYTES);
+	rx_dma_sync(0);
+}
+
+//function definition in uart.h file
+void uart_rx_dma(int enable)
+{
+	// no byte may be received between the two paths
+	uint32_t interrupt_mask = __get_PRIMASK();
+	__disable_irq();
+
+	if (enable)
+	{
+		SIM->SCGC7 |= SIM_SCGC7_DMA_MASK;
+		SIM->SCGC6 |= SIM_SCGC6_DMAMUX_MASK;
+		DMAMUX0->CHCFG[RX_DMA_CHANNEL] = 0;
+
+		// data register into the fifo storage, continuing after the bytes
+		// already queued, wrapping on the storage size
+		DMA0->DMA[RX_DMA_CHANNEL].DSR_BCR = DMA_DSR_BCR_DONE_MASK;
+		DMA0->DMA[RX_DMA_CHANNEL].SAR = DMA_SAR_SAR((uint32_t)&UART0->D);
+		DMA0->DMA[RX_DMA_CHANNEL].DAR = DMA_DAR_DAR((uint32_t)&receive_storage[
+				receive_cbfifo.head & (RX_BUFFER_SIZE - 1)]);
+		DMA0->DMA[RX_DMA_CHANNEL].DSR_BCR = DMA_DSR_BCR_BCR(RX_DMA_BYTES);
+		rx_dma_rearmed = 0;
+		rx_dma_synced = 0;
+		DMA0->DMA[RX_DMA_CHANNEL].DCR = DMA_DCR_EINT_MASK | DMA_DCR_ERQ_MASK
+				| DMA_DCR_CS_MASK | DMA_DCR_DINC_MASK | DMA_DCR_SSIZE(DMA_SIZE_8BIT)
+				| DMA_DCR_DSIZE(DMA_SIZE_8BIT) | DMA_DCR_DMOD(RX_DMA_DMOD);
+
+		NVIC_SetPriority(DMA2_IRQn, 2);
+		NVIC_ClearPendingIRQ(DMA2_IRQn);
+		NVIC_EnableIRQ(DMA2_IRQn);
+		DMAMUX0->CHCFG[RX_DMA_CHANNEL] = DMAMUX_CHCFG_SOURCE(RX_DMAMUX_SOURCE)
+				| DMAMUX_CHCFG_ENBL_MASK;
+
+		// RDRF raises a DMA request instead of an interrupt, the idle line
+		// interrupt flushes what the DMA received
+		UART0->C5 |= UART0_C5_RDMAE_MASK;
+		UART0->C2 |= UART0_C2_ILIE_MASK;
+		rx_dma_enabled = 1;
+	}
+	else
+	{
+		// stop the requests first, a byte arriving from here on waits in
+		// the data register for the interrupt path
+		UART0->C5 &= ~UART0_C5_RDMAE_MASK;
+		UART0->C2 &= ~UART0_C2_ILIE_MASK;
+		DMA0->DMA[RX_DMA_CHANNEL].DCR &= ~DMA_DCR_ERQ_MASK;
+		DMAMUX0->CHCFG[RX_DMA_CHANNEL] = 0;
+
+		// publish everything the DMA received before the interrupt path resumes
+		rx_dma_sync(1);
+		NVIC_DisableIRQ(DMA2_IRQn);
+		rx_dma_enabled = 0;
+	}
+
+	__set_PRIMASK(interrupt_mask);
+}
+
+// discards the oldest queued output, including the part of a DMA transfer
+// not sent yet
+static void tx_discard_oldest(size_t nbyte)
+{
+	// the transmit handlers are the consumers of the fifo, they must not
+	// run while the tail is moved from here
+	uint32_t interrupt_mask = __get_PRIMASK();
+	size_t length;
+	__disable_irq();
+
+	// stop the transfer, the bytes it did not send become ordinary output
+	if (tx_dma_span)
+	{
+		DMA0->DMA[TX_DMA_CHANNEL].DCR &= ~DMA_DCR_ERQ_MASK;
+		cbfifo_consume(&transmit_cbfifo, tx_dma_span
+				- (DMA0->DMA[TX_DMA_CHANNEL].DSR_BCR & DMA_DSR_BCR_BCR_MASK));
+		DMA0->DMA[TX_DMA_CHANNEL].DSR_BCR = DMA_DSR_BCR_DONE_MASK;
+		NVIC_ClearPendingIRQ(DMA1_IRQn);
+		tx_dma_span = 0;
+	}
+
+	length = cbfifo_length(&transmit_cbfifo);
+	if (nbyte > length)
+		nbyte = length;
+	cbfifo_consume(&transmit_cbfifo, nbyte);
+	tx_dropped += nbyte;
+
+	__set_PRIMASK(interrupt_mask);
+}
+
 //function definition in uart.h file
 int __sys_write(int handle, char *buf, int size)
 {
-	// wait while the transmit buffer is full
-	while (cbfifo_length(&transmit_cbfifo) == cbfifo_capacity(&transmit_cbfifo))
-		;
-	// if enqueued the requested bytes set the transmit interrupt and send data
-	if (cbfifo_enqueue(buf, size, &transmit_cbfifo) == size)
+	// output discarded by the policy is not an error, it is counted
+	uart_write((const uint8_t *)buf, size);
+	return 0;
+}
+
+//function definition in uart.h file
+size_t uart_write(const uint8_t *data, size_t length)
+{
+	size_t capacity = cbfifo_capacity(&transmit_cbfifo);
+	size_t written = 0;
+	uint8_t *span;
+	size_t chunk;
+
+	switch (tx_policy)
 	{
-		if (!(UART0->C2 & UART0_C2_TIE_MASK))
+	case UART_TX_DROP_COUNTED:
+		// whole writes only, a line is sent complete or not at all
+		if (length > capacity - cbfifo_length(&transmit_cbfifo))
+		{
+			tx_dropped += length;
+			return 0;
+		}
+		break;
+
+	case UART_TX_OVERWRITE_OLDEST:
+		// only the newest capacity bytes of a long write can be kept
+		if (length > capacity)
 		{
-			UART0->C2 |= UART0_C2_TIE(1);
+			tx_dropped += length - capacity;
+			data += length - capacity;
+			length = capacity;
 		}
+		if (length > capacity - cbfifo_length(&transmit_cbfifo))
+			tx_discard_oldest(length - (capacity - cbfifo_length(&transmit_cbfifo)));
+		break;
+
+	default:
+		break;
 	}
-	// error condition data unable to write
-	else
+
+	// copy straight into the fifo, only the blocking policy waits for
+	// the transmitter to make room
+	while (written < length)
 	{
-		return -1;
+		chunk = cbfifo_reserve(&transmit_cbfifo, &span);
+		if (chunk == 0)
+		{
+			if (tx_policy == UART_TX_BLOCK)
+				continue;
+			break;
+		}
+		if (chunk > length - written)
+			chunk = length - written;
+		memcpy(span, &data[written], chunk);
+		cbfifo_commit(&transmit_cbfifo, chunk);
+		written += chunk;
+		start_transmit();
 	}
-	return 0;
 
+	tx_dropped += length - written;
+	return written;
+}
+
+//function definition in uart.h file
+void uart_tx_policy(uart_tx_policy_t policy)
+{
+	tx_policy = policy;
+}
+
+//function definition in uart.h file
+uint32_t uart_tx_dropped(void)
+{
+	return tx_dropped;
+}
+
+//function definition in uart.h file
+uint32_t uart_rx_overruns(void)
+{
+	return rx_overruns;
+}
+
+//function definition in uart.h file
+void uart_flush(void)
+{
+	// queued bytes, then the last character in the shift register
+	while (uart_tx_pending())
+		;
+	while (!(UART0->S1 & UART0_S1_TC_MASK))
+		;
 }
 
 //function definition in uart.h file
@@ -185,8 +520,10 @@ int __sys_readc(void)
 	// declare a variable to store the received character
 	uint8_t character;
 	// while the receive fifo is empty wait
-	while (cbfifo_length(&receive_cbfifo) == 0)
-		;
+	do
+	{
+		rx_dma_sync(1);
+	} while (cbfifo_length(&receive_cbfifo) == 0);
 	//if 1 character dequeued then return the character
 	if (cbfifo_dequeue(&character, 1, &receive_cbfifo) == 1)
 	{
@@ -198,6 +535,52 @@ int __sys_readc(void)
 	}
 }
 
+//function definition in uart.h file
+int uart_try_getchar(void)
+{
+	uint8_t character;
+
+	// nothing received, do not wait
+	rx_dma_sync(1);
+	if (cbfifo_dequeue(&character, 1, &receive_cbfifo) != 1)
+		return -1;
+	return character;
+}
+
+//function definition in uart.h file
+size_t uart_read(uint8_t *data, size_t length)
+{
+	size_t received = 0;
+
+	// blocking, takes whatever the fifo holds until length bytes arrived
+	while (received < length)
+	{
+		rx_dma_sync(1);
+		received += cbfifo_dequeue(&data[received], length - received, &receive_cbfifo);
+	}
+	return length;
+}
+
+// function definition in header file
+size_t uart_read_timeout(uint8_t *data, size_t length, uint32_t timeout_us)
+{
+	size_t received = 0;
+	size_t count;
+	uint64_t last = timebase_now_us();
+
+	// the timeout restarts with every byte, a slow but live sender is kept
+	while (received < length && timebase_now_us() - last < timeout_us)
+	{
+		rx_dma_sync(1);
+		count = cbfifo_dequeue(&data[received], length - received, &receive_cbfifo);
+		if (count > 0) {
+			received += count;
+			last = timebase_now_us();
+		}
+	}
+	return received;
+}
+
 // function definition in header file
 uint16_t get_deci_input()
 {
@@ -240,3 +623,63 @@ uint16_t get_deci_input()
     return number;
 }
 
+
+// function definition in header file
+int32_t get_centi_input()
+{
+    //initialize the variables for digit store
+    uint8_t digit = 0;
+    uint8_t digit_store[MAX_INPUT_DIGITS + CENTI_DIGITS];
+    int counter = 0;
+    int point_position = -1;
+    int32_t number = 0;
+
+    //while digit is not 13 (carriage return)
+    while(digit != CARRIAGE_RETURN)
+    {
+        //store the character
+        digit=getchar();
+        //accept digits, at most two of them after the decimal point
+        if((digit >= MIN_DIGIT) && (digit <= MAX_DIGIT) && counter < MAX_INPUT_DIGITS
+                && (point_position < 0 || counter - point_position < CENTI_DIGITS))
+        {
+            putchar(digit);
+            digit_store[counter] = digit - MIN_DIGIT;
+            counter++;
+        }
+        //accept a single decimal point
+        else if(digit == DECIMAL_POINT && point_position < 0)
+        {
+            putchar(digit);
+            point_position = counter;
+        }
+        //check if user entered backspace
+        else if(digit == BACKSPACE && (counter > 0 || point_position >= 0))
+        {
+            putchar(BACKSPACE);     //print backspace
+            putchar(SPACE);         //print space
+            putchar(BACKSPACE);     //print backspace
+            //remove the decimal point if it was the last character
+            if(point_position == counter)
+                point_position = -1;
+            else
+                counter--;
+        }
+    }
+    printf("\n\r");
+
+    //pad the missing fractional digits with zeros
+    if(point_position < 0)
+        point_position = counter;
+    while(counter - point_position < CENTI_DIGITS)
+        digit_store[counter++] = 0;
+
+    //calculated the number from the array
+    for(int buffer_number=0; buffer_number < counter; buffer_number++)
+    {
+        number*= DECIMAL_CONVERSION;
+        number+= digit_store[buffer_number];
+    }
+    //return the number
+    return number;
+}
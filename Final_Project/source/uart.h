@@ -25,10 +25,20 @@
 
 //including required libs
 #include <stdint.h>
+#include <stddef.h>
 
 //defining the BAUD RATE for uart communication
 #define BAUD_RATE (38400)
 
+//what a write does when the transmit buffer is full
+typedef enum
+{
+	UART_TX_BLOCK = 0,			// wait for the transmitter, nothing is lost
+	UART_TX_DROP_NEWEST,		// keep what fits, discard the rest of the write
+	UART_TX_OVERWRITE_OLDEST,	// discard the oldest queued output to make room
+	UART_TX_DROP_COUNTED		// discard a write that does not fit as a whole
+} uart_tx_policy_t;
+
 /*****************************************************************************
 * Initializes the UART0 module of KL25Z for the provided baud rate
 *
@@ -46,6 +56,50 @@ void Init_Uart0(uint32_t baud_rate);
 *****************************************************************************/
 void UART0_IRQHandler(void);
 
+/*****************************************************************************
+* Switches the transmit path between one interrupt per character and DMA
+* channel 1, which sends contiguous spans of the transmit fifo with one
+* interrupt per span. Waits until the queued output is sent
+*
+* Parameters:
+*   enable      			1 for DMA, 0 for the interrupt per character
+*
+*****************************************************************************/
+void uart_tx_dma(int enable);
+
+/*****************************************************************************
+* DMA channel 1 transfer complete handler, sends the next span
+*
+*****************************************************************************/
+void DMA1_IRQHandler(void);
+
+/*****************************************************************************
+* Switches the receive path between one interrupt per character and DMA
+* channel 2, which writes the received bytes straight into the circular
+* receive buffer. The bytes are handed to the readers when the line goes
+* idle, when a reader polls, and when the DMA transfer count is rearmed.
+* When more than the buffer size arrives unread the DMA overwrites it, the
+* next read then drops all unread input and counts an overrun
+*
+* Parameters:
+*   enable      			1 for DMA, 0 for the interrupt per character
+*
+*****************************************************************************/
+void uart_rx_dma(int enable);
+
+/*****************************************************************************
+* DMA channel 2 transfer complete handler, rearms the receive transfer
+*
+*****************************************************************************/
+void DMA2_IRQHandler(void);
+
+/*****************************************************************************
+* Returns the number of bytes waiting to be sent, including a DMA transfer
+* in progress
+*
+*****************************************************************************/
+size_t uart_tx_pending(void);
+
 /*****************************************************************************
 * This function ties the inbuild reading functions such as getchar(),
 * scanf() etc to the UART
@@ -60,6 +114,86 @@ int __sys_readc(void);
 *****************************************************************************/
 int __sys_write(int handle, char *buf, int size);
 
+/*****************************************************************************
+* Writes binary data to the uart, following the transmit policy when the
+* transmit buffer is full
+*
+* Parameters:
+*   data      				bytes to send
+*   length      			number of bytes
+*
+* Returns:
+*   number of bytes queued, length unless some were dropped
+*
+*****************************************************************************/
+size_t uart_write(const uint8_t *data, size_t length);
+
+/*****************************************************************************
+* Selects what uart_write() and printf() do when the transmit buffer is
+* full. Only UART_TX_BLOCK waits, the other policies discard output and
+* count it
+*
+* Parameters:
+*   policy      			new transmit policy
+*
+*****************************************************************************/
+void uart_tx_policy(uart_tx_policy_t policy);
+
+/*****************************************************************************
+* Returns the number of output bytes discarded by the transmit policies
+*
+*****************************************************************************/
+uint32_t uart_tx_dropped(void);
+
+/*****************************************************************************
+* Returns the number of times the receive DMA overran unread input, each
+* dropped everything that was unread
+*
+*****************************************************************************/
+uint32_t uart_rx_overruns(void);
+
+/*****************************************************************************
+* Waits until all the queued output has left the transmitter
+*
+*****************************************************************************/
+void uart_flush(void);
+
+/*****************************************************************************
+* Returns a received character without waiting
+*
+* Returns:
+*   the character, or -1 if nothing was received
+*
+*****************************************************************************/
+int uart_try_getchar(void);
+
+/*****************************************************************************
+* Reads binary data from the uart, waiting until length bytes are received
+*
+* Parameters:
+*   data      				received bytes
+*   length      			number of bytes
+*
+* Returns:
+*   number of bytes read, always length
+*
+*****************************************************************************/
+size_t uart_read(uint8_t *data, size_t length);
+
+/*****************************************************************************
+* Reads binary data from the uart, giving up when the line stays quiet
+*
+* Parameters:
+*   data      				received bytes
+*   length      			number of bytes
+*   timeout_us      		longest wait for the next byte in us
+*
+* Returns:
+*   number of bytes read, less than length on a timeout
+*
+*****************************************************************************/
+size_t uart_read_timeout(uint8_t *data, size_t length, uint32_t timeout_us);
+
 /*****************************************************************************
 * This function takes user input from the uart continuously and calls
 * respective function according to the commands
@@ -69,4 +203,14 @@ void read_uart_input();
 
 uint16_t get_deci_input();
 
+/*****************************************************************************
+* Reads a decimal number with up to two fractional digits from the uart,
+* e.g. "12.5" or "30.25", terminated by carriage return
+*
+* Returns:
+*   the number in hundredths (e.g. 1250 for "12.5")
+*
+*****************************************************************************/
+int32_t get_centi_input();
+
 #endif /* UART_H_ */